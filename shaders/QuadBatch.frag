@@ -5,62 +5,64 @@ layout(location = 1) in vec4 Color;
 layout(location = 2) in float Texture;
 layout(location = 0) out vec4 FragColor;
 
-layout(binding = 0) uniform sampler2D u_Textures[16];
+//every slot has a texture array, Texture is slot * 256 + layer (see c_MaxQuadTextureArrayLayers)
+layout(binding = 0) uniform sampler2DArray u_Textures[16];
 
 void main()
 {
     int tex = int(round(Texture));
+    vec3 coordinates = vec3(TextureCoordinates, float(tex % 256));
     FragColor = vec4(0,0,0,0);
 
-    switch(tex)
+    switch(tex / 256)
     {
         case 0:
-            FragColor = texture(u_Textures[0], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[0], coordinates) * Color;
             break;
         case 1:
-            FragColor = texture(u_Textures[1], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[1], coordinates) * Color;
             break;
         case 2:
-            FragColor = texture(u_Textures[2], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[2], coordinates) * Color;
             break;
         case 3:
-            FragColor = texture(u_Textures[3], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[3], coordinates) * Color;
             break;
         case 4:
-            FragColor = texture(u_Textures[4], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[4], coordinates) * Color;
             break;
         case 5:
-            FragColor = texture(u_Textures[5], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[5], coordinates) * Color;
             break;
         case 6:
-            FragColor = texture(u_Textures[6], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[6], coordinates) * Color;
             break;
         case 7:
-            FragColor = texture(u_Textures[7], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[7], coordinates) * Color;
             break;
         case 8:
-            FragColor = texture(u_Textures[8], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[8], coordinates) * Color;
             break;
         case 9:
-            FragColor = texture(u_Textures[9], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[9], coordinates) * Color;
             break;
         case 10:
-            FragColor = texture(u_Textures[10], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[10], coordinates) * Color;
             break;
         case 11:
-            FragColor = texture(u_Textures[11], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[11], coordinates) * Color;
             break;
         case 12:
-            FragColor = texture(u_Textures[12], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[12], coordinates) * Color;
             break;
         case 13:
-            FragColor = texture(u_Textures[13], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[13], coordinates) * Color;
             break;
         case 14:
-            FragColor = texture(u_Textures[14], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[14], coordinates) * Color;
             break;
         case 15:
-            FragColor = texture(u_Textures[15], TextureCoordinates) * Color;
+            FragColor = texture(u_Textures[15], coordinates) * Color;
             break;
     }
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 420 core
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in float aScale;
+layout(location = 2) in uint aColor;
+layout(location = 3) in uint aTexture;
+layout(location = 4) in uint aUVMin;
+layout(location = 5) in uint aUVMax;
+
+#include <common/SceneData.glsli>
+
+layout(location = 0) out vec2 TextureCoordinates;
+layout(location = 1) out vec4 Color;
+layout(location = 2) out float Texture;
+
+//corners of the 2 triangles of the unit quad, in the same order as the quad batch indices
+const vec2 c_QuadCorners[6] = vec2[6](
+    vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0),
+    vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(1.0, 0.0)
+);
+
+void main()
+{
+    vec2 corner = c_QuadCorners[gl_VertexID];
+
+    gl_Position = u_ViewProjection * vec4(aPos + corner * aScale, 0.0, 1.0);
+	Color = unpackUnorm4x8(aColor);
+	Texture = float(aTexture);
+	TextureCoordinates = mix(unpackUnorm2x16(aUVMin), unpackUnorm2x16(aUVMax), corner);
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+namespace Ainan {
+
+	//a queue with a fixed capacity used to pass work from one thread to another.
+	//Push waits while the queue is full and Pop waits while it's empty, so a producer that is faster than its consumer
+	//waits for it instead of piling up work.
+	//Close wakes up every waiting thread, after it Push fails and Pop fails once the items left in the queue are taken
+	template<typename T>
+	class BoundedQueue
+	{
+	public:
+		BoundedQueue(size_t capacity) :
+			m_Capacity(capacity)
+		{
+		}
+
+		//returns false if the queue was closed, the item isn't added in that case
+		bool Push(T item)
+		{
+			std::unique_lock lock(m_Mutex);
+			m_NotFullCV.wait(lock, [this]() { return m_Items.size() < m_Capacity || m_Closed; });
+			if (m_Closed)
+				return false;
+
+			m_Items.push_back(std::move(item));
+			lock.unlock();
+			m_NotEmptyCV.notify_one();
+			return true;
+		}
+
+		//returns false if the queue was closed and has nothing left in it
+		bool Pop(T& item)
+		{
+			std::unique_lock lock(m_Mutex);
+			m_NotEmptyCV.wait(lock, [this]() { return !m_Items.empty() || m_Closed; });
+			if (m_Items.empty())
+				return false;
+
+			item = std::move(m_Items.front());
+			m_Items.pop_front();
+			lock.unlock();
+			m_NotFullCV.notify_one();
+			return true;
+		}
+
+		void Close()
+		{
+			{
+				std::lock_guard lock(m_Mutex);
+				m_Closed = true;
+			}
+			m_NotFullCV.notify_all();
+			m_NotEmptyCV.notify_all();
+		}
+
+	private:
+		std::deque<T> m_Items;
+		size_t m_Capacity;
+		bool m_Closed = false;
+		std::mutex m_Mutex;
+		std::condition_variable m_NotFullCV;
+		std::condition_variable m_NotEmptyCV;
+	};
+}
@@ -0,0 +1,188 @@
+#include "ThreadPool.h"
+
+namespace Ainan {
+
+	struct ParallelForJob
+	{
+		const std::function<void(size_t, size_t)>* Func = nullptr;
+		std::atomic<size_t> RemainingChunks = 0;
+	};
+
+	struct PoolTask
+	{
+		ParallelForJob* Job = nullptr;
+		size_t Begin = 0;
+		size_t End = 0;
+	};
+
+	struct WorkerQueue
+	{
+		std::mutex Mutex;
+		std::deque<PoolTask> Tasks;
+	};
+
+	static void WorkerLoop(uint32_t workerIndex);
+	static bool RunOneTask(uint32_t preferredQueue);
+	static void RunTask(const PoolTask& task);
+
+	static std::vector<std::thread> s_Workers;
+	static std::unique_ptr<WorkerQueue[]> s_Queues;
+	static uint32_t s_QueueCount = 0;
+
+	//number of tasks pushed to the queues that have not been taken yet, workers sleep when it is 0
+	static std::atomic<size_t> s_PendingTasks = 0;
+	static std::atomic<uint32_t> s_NextQueue = 0;
+	static std::atomic_bool s_Terminate = false;
+	static std::mutex s_WakeMutex;
+	static std::condition_variable s_WakeCondition;
+
+	void ThreadPool::Init(uint32_t workerCount)
+	{
+		if (s_Workers.size() > 0)
+			return;
+
+		if (workerCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		s_Terminate = false;
+		s_QueueCount = workerCount;
+		s_Queues = std::make_unique<WorkerQueue[]>(workerCount);
+
+		for (uint32_t i = 0; i < workerCount; i++)
+			s_Workers.push_back(std::thread([i]() { WorkerLoop(i); }));
+	}
+
+	void ThreadPool::Terminate()
+	{
+		{
+			std::lock_guard lock(s_WakeMutex);
+			s_Terminate = true;
+		}
+		s_WakeCondition.notify_all();
+
+		for (auto& worker : s_Workers)
+			worker.join();
+
+		s_Workers.clear();
+		s_Queues.reset();
+		s_QueueCount = 0;
+	}
+
+	uint32_t ThreadPool::GetWorkerCount()
+	{
+		return (uint32_t)s_Workers.size();
+	}
+
+	void ThreadPool::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& func)
+	{
+		if (count == 0)
+			return;
+
+		chunkSize = std::max(chunkSize, (size_t)1);
+		size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+		//not worth waking up the workers
+		if (chunkCount == 1 || s_QueueCount == 0)
+		{
+			for (size_t begin = 0; begin < count; begin += chunkSize)
+				func(begin, std::min(begin + chunkSize, count));
+			return;
+		}
+
+		ParallelForJob job;
+		job.Func = &func;
+		job.RemainingChunks = chunkCount;
+
+		//count the tasks before pushing them, otherwise a worker can pop a task and decrement the counter below 0
+		s_PendingTasks += chunkCount;
+
+		//spread the chunks over all the queues so that every worker starts with some work
+		uint32_t firstQueue = s_NextQueue++ % s_QueueCount;
+		for (size_t chunk = 0; chunk < chunkCount; chunk++)
+		{
+			PoolTask task;
+			task.Job = &job;
+			task.Begin = chunk * chunkSize;
+			task.End = std::min(task.Begin + chunkSize, count);
+
+			WorkerQueue& queue = s_Queues[(firstQueue + chunk) % s_QueueCount];
+			std::lock_guard lock(queue.Mutex);
+			queue.Tasks.push_back(task);
+		}
+
+		//taking the lock makes sure a worker that is about to wait sees the new tasks or gets the notification
+		{
+			std::lock_guard lock(s_WakeMutex);
+		}
+		s_WakeCondition.notify_all();
+
+		//help with the work instead of just waiting, this also makes calling this from inside a task safe
+		while (job.RemainingChunks.load(std::memory_order_acquire) > 0)
+		{
+			if (!RunOneTask(firstQueue))
+				std::this_thread::yield();
+		}
+	}
+
+	void WorkerLoop(uint32_t workerIndex)
+	{
+		while (true)
+		{
+			if (RunOneTask(workerIndex))
+				continue;
+
+			std::unique_lock lock(s_WakeMutex);
+			s_WakeCondition.wait(lock, []() { return s_PendingTasks > 0 || s_Terminate; });
+
+			if (s_Terminate)
+				break;
+		}
+	}
+
+	//runs one task, looking in the preferred queue first then stealing from the others.
+	//returns false if there was nothing to run
+	bool RunOneTask(uint32_t preferredQueue)
+	{
+		for (uint32_t i = 0; i < s_QueueCount; i++)
+		{
+			WorkerQueue& queue = s_Queues[(preferredQueue + i) % s_QueueCount];
+
+			PoolTask task;
+			{
+				std::lock_guard lock(queue.Mutex);
+				if (queue.Tasks.empty())
+					continue;
+
+				//take the newest task from our own queue (it's most likely still in cache)
+				//and the oldest one when stealing from another queue
+				if (i == 0)
+				{
+					task = queue.Tasks.back();
+					queue.Tasks.pop_back();
+				}
+				else
+				{
+					task = queue.Tasks.front();
+					queue.Tasks.pop_front();
+				}
+			}
+
+			s_PendingTasks--;
+			RunTask(task);
+			return true;
+		}
+
+		return false;
+	}
+
+	void RunTask(const PoolTask& task)
+	{
+		(*task.Job->Func)(task.Begin, task.End);
+
+		//NOTE: the job lives on the stack of the thread that called ParallelFor, so it must not be touched after this
+		task.Job->RemainingChunks.fetch_sub(1, std::memory_order_release);
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace Ainan {
+
+	//a pool of worker threads shared by the whole application.
+	//every worker owns a queue of tasks, it takes work from the back of its own queue and
+	//steals from the front of the other queues when it runs out.
+	class ThreadPool
+	{
+	public:
+		//workerCount of 0 means one worker for every hardware thread except the calling one
+		static void Init(uint32_t workerCount = 0);
+		static void Terminate();
+
+		//splits [0, count) into chunks of chunkSize and calls func(begin, end) for every chunk.
+		//the calling thread runs chunks too and this only returns when all of them are done.
+		//the chunk boundaries depend only on count and chunkSize (and not on the number of workers or timing),
+		//so as long as chunks write to separate data the result is the same as running them in order.
+		static void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& func);
+
+		static uint32_t GetWorkerCount();
+	};
+}
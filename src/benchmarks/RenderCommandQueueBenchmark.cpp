@@ -0,0 +1,207 @@
+//measures how many render commands per second go from the main thread to the renderer thread.
+//it compares the mutex protected queue the renderer used to have with the current per-frame command buffers,
+//the commands do no work so only the cost of the queue itself is measured.
+//it also measures a streaming vertex buffer that is flushed more times a frame than it has regions, waiting for
+//the renderer thread to be idle (before) against waiting for the fence of the region that is reused.
+//usage: RenderCommandQueueBenchmark [command count] [commands per frame] [flushes per frame]
+
+#include "renderer/RenderCommandQueue.h"
+
+namespace Ainan {
+
+	//the render command queue from before the command buffers, kept here only to compare against
+	class LockedRenderCommandQueue
+	{
+		const size_t c_MaxQueueSize = 10;
+
+	public:
+		void Push(const RenderCommand& cmd)
+		{
+			if (m_InternalQueue.size() >= c_MaxQueueSize)
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WorkConsumedCV.wait(lock, [this]() { return m_InternalQueue.size() < c_MaxQueueSize; });
+			}
+
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_InternalQueue.push(cmd);
+			m_WorkAvailableCV.notify_one();
+		}
+
+		//the old queue executed commands as soon as they were pushed, there was nothing to submit
+		void Submit() {}
+
+		void WaitUntilIdle()
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkDoneCV.wait(lock, [this]() { return m_InternalQueue.empty() && (m_Busy == false); });
+		}
+
+		void WaitPopAndExecuteAll(std::function<void(const RenderCommand&)> func)
+		{
+			std::unique_lock<std::mutex> latch(m_Mutex);
+			using namespace std::chrono_literals;
+			m_WorkAvailableCV.wait_for(latch, 20ms, [this]() { return !m_InternalQueue.empty(); });
+			while (!m_InternalQueue.empty())
+			{
+				m_Busy = true;
+				auto cmd = m_InternalQueue.front();
+				m_InternalQueue.pop();
+				latch.unlock();
+
+				m_WorkConsumedCV.notify_one();
+				func(cmd);
+
+				latch.lock();
+				m_Busy = false;
+			}
+
+			m_WorkDoneCV.notify_one();
+		}
+
+	private:
+		std::queue<RenderCommand> m_InternalQueue;
+		std::condition_variable m_WorkAvailableCV;
+		std::condition_variable m_WorkDoneCV;
+		std::condition_variable m_WorkConsumedCV;
+		std::mutex m_Mutex;
+		bool m_Busy = false;
+	};
+
+	//pushes commandCount commands, submitting every commandsPerFrame commands like Renderer::Present does,
+	//and returns the commands executed per second
+	template<typename Queue>
+	double MeasureQueue(size_t commandCount, size_t commandsPerFrame)
+	{
+		Queue queue;
+		std::atomic_bool stop = false;
+		size_t executedCount = 0;
+
+		std::thread rendererThread([&]()
+			{
+				auto execCmd = [&executedCount](const RenderCommand& cmd) { executedCount++; };
+				while (!stop)
+					queue.WaitPopAndExecuteAll(execCmd);
+			});
+
+		RenderCommand cmd;
+		cmd.Type = RenderCommandType::Clear;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (size_t i = 0; i < commandCount; i++)
+		{
+			queue.Push(cmd);
+			if ((i + 1) % commandsPerFrame == 0)
+				queue.Submit();
+		}
+		queue.WaitUntilIdle();
+		auto end = std::chrono::high_resolution_clock::now();
+
+		stop = true;
+		rendererThread.join();
+
+		if (executedCount != commandCount)
+			std::cout << "ERROR: executed " << executedCount << " of " << commandCount << " commands\n";
+
+		double seconds = std::chrono::duration<double>(end - start).count();
+		return commandCount / seconds;
+	}
+
+	//like c_StreamingBufferRegionCount in Renderer.h
+	const size_t c_StreamingRegionCount = 3;
+	//how long the renderer thread takes to execute a simulated draw
+	const auto c_SimulatedDrawTime = std::chrono::microseconds(50);
+
+	//records frameCount frames that flush a streaming buffer flushesPerFrame times, every flush is a draw followed by a fence
+	//that is passed once the renderer thread executed the draw. a region is reused once the fence after its last draw
+	//is passed, waitUntilIdle waits for every command instead of that fence. returns the frames per second
+	double MeasureStreamingFlushes(size_t frameCount, size_t flushesPerFrame, bool waitUntilIdle)
+	{
+		RenderCommandQueue queue;
+		std::atomic_bool stop = false;
+
+		std::thread rendererThread([&]()
+			{
+				auto execCmd = [](const RenderCommand& cmd)
+				{
+					if (cmd.Type == RenderCommandType::CustomCommand)
+						cmd.CustomCommand();
+				};
+				while (!stop)
+					queue.WaitPopAndExecuteAll(execCmd);
+			});
+
+		std::array<std::atomic_bool, c_StreamingRegionCount> fences;
+		for (auto& fence : fences)
+			fence = true;
+
+		size_t region = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (size_t frame = 0; frame < frameCount; frame++)
+		{
+			for (size_t flush = 0; flush < flushesPerFrame; flush++)
+			{
+				std::atomic_bool& fence = fences[region];
+				if (!fence.load(std::memory_order_acquire))
+				{
+					if (waitUntilIdle)
+						queue.WaitUntilIdle();
+					else
+					{
+						queue.Submit();
+						while (!fence.load(std::memory_order_acquire))
+							std::this_thread::yield();
+					}
+				}
+
+				fence.store(false, std::memory_order_relaxed);
+				queue.Push(RenderCommand([]()
+					{
+						auto end = std::chrono::steady_clock::now() + c_SimulatedDrawTime;
+						while (std::chrono::steady_clock::now() < end);
+					}));
+				queue.Push(RenderCommand([&fence]() { fence.store(true, std::memory_order_release); }));
+				region = (region + 1) % c_StreamingRegionCount;
+			}
+
+			queue.Submit();
+		}
+		queue.WaitUntilIdle();
+		auto end = std::chrono::high_resolution_clock::now();
+
+		stop = true;
+		rendererThread.join();
+
+		double seconds = std::chrono::duration<double>(end - start).count();
+		return frameCount / seconds;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace Ainan;
+
+	size_t commandCount = argc > 1 ? std::stoull(argv[1]) : 2000000;
+	size_t commandsPerFrame = argc > 2 ? std::max(std::stoull(argv[2]), 1ull) : 1000;
+	size_t flushesPerFrame = argc > 3 ? std::max(std::stoull(argv[3]), 1ull) : 6;
+
+	std::cout << commandCount << " commands, submitted every " << commandsPerFrame << " commands\n";
+
+	double lockedRate = MeasureQueue<LockedRenderCommandQueue>(commandCount, commandsPerFrame);
+	std::cout << "mutex queue (before):        " << lockedRate / 1e6 << " M commands/sec\n";
+
+	double commandBufferRate = MeasureQueue<RenderCommandQueue>(commandCount, commandsPerFrame);
+	std::cout << "per-frame command buffers:   " << commandBufferRate / 1e6 << " M commands/sec\n";
+
+	const size_t frameCount = 1000;
+	std::cout << "\nstreaming buffer with " << c_StreamingRegionCount << " regions flushed " << flushesPerFrame << " times a frame, " <<
+		c_SimulatedDrawTime.count() << "us per draw\n";
+
+	double idleFps = MeasureStreamingFlushes(frameCount, flushesPerFrame, true);
+	std::cout << "wait until idle (before):    " << idleFps << " frames/sec\n";
+
+	double fenceFps = MeasureStreamingFlushes(frameCount, flushesPerFrame, false);
+	std::cout << "wait for the region's fence: " << fenceFps << " frames/sec\n";
+
+	return 0;
+}
@@ -180,22 +180,22 @@ namespace Ainan
 			if (m_State == State_PlayMode)
 			{
 
-				ImVec2 displayPos = ImGui::GetDrawData()->DisplayPos;
-				ImVec2 displaySize = ImGui::GetDrawData()->DisplaySize;
-				ImVec2 fbScale = ImGui::GetDrawData()->FramebufferScale;
-				auto& windowsAboveViewport = Renderer::Rdata->WindowsAboveViewport;
-				Renderer::PushCommand([this, displayPos, displaySize, fbScale, windowsAboveViewport]()
+				auto list = Renderer::Rdata->WindowsAboveViewport;
+				list.insert(list.begin(), m_ViewportWindow.pDrawEnvImGuiCmd);
+
+				ImDrawData data;
+				data.DisplayPos = ImGui::GetDrawData()->DisplayPos;
+				data.DisplaySize = ImGui::GetDrawData()->DisplaySize;
+				data.FramebufferScale = ImGui::GetDrawData()->FramebufferScale;
+				data.CmdListsCount = list.size();
+				data.CmdLists = list.data();
+
+				//the lists are changed by the next ImGui frame, which can start before this is drawn
+				ImDrawData* drawData = Renderer::CopyImGuiDrawData(&data);
+				Renderer::PushCommand([drawData]()
 					{
-						auto list = windowsAboveViewport;
-						list.insert(list.begin(), m_ViewportWindow.pDrawEnvImGuiCmd);
-
-						ImDrawData data;
-						data.DisplayPos = displayPos;
-						data.DisplaySize = displaySize;
-						data.FramebufferScale = fbScale;
-						data.CmdListsCount = list.size();
-						data.CmdLists = list.data();
-						Renderer::Rdata->CurrentActiveAPI->DrawImGui(&data);
+						Renderer::Rdata->CurrentActiveAPI->DrawImGui(drawData);
+						Renderer::DeleteImGuiDrawData(drawData);
 					});
 			}
 		}
@@ -622,15 +622,33 @@ namespace Ainan
 		if (camera.GetProjectionMode() == ProjectionMode::Perspective)
 			m_Env->EnvSkybox.Draw(camera);
 
+		//objects are drawn sorted by their draw keys in EndScene so that objects that use the same state are drawn together,
+		//blended objects (sprites and particle systems) still keep the order they have in the objects list
 		for (pEnvironmentObject& obj : m_Env->Objects)
 		{
-			auto mutexPtr = obj->GetMutex();
-			std::lock_guard lock(*mutexPtr);
-			obj->Draw();
+			EnvironmentObjectInterface* object = obj.get();
+			DrawKey key;
+			bool draws;
+			{
+				auto mutexPtr = object->GetMutex();
+				std::lock_guard lock(*mutexPtr);
+				draws = object->GetDrawKey(key);
+			}
+
+			if (draws)
+				Renderer::SubmitDrawPacket(key, [object]()
+					{
+						auto mutexPtr = object->GetMutex();
+						std::lock_guard lock(*mutexPtr);
+						object->Draw();
+					});
 		}
 
 		Renderer::EndScene();
 		m_DrawCalls = Renderer::Rdata->NumberOfDrawCallsLastScene;
+		m_DrawPackets = Renderer::Rdata->NumberOfDrawPacketsLastScene;
+		m_StateChangesSaved = Renderer::Rdata->StateChangesSavedLastScene;
+		m_DrawCallsSaved = Renderer::Rdata->DrawCallsSavedLastScene;
 
 		//draw the UI as a different scene on top of the environment scene
 		SceneDescription descUI;
@@ -1775,6 +1793,14 @@ namespace Ainan
 			ImGui::Text("Draw Calls: ");
 			ImGui::SameLine();
 			ImGui::TextColored({ 0.0f,0.8f,0.0f,1.0f }, std::to_string(m_DrawCalls).c_str());
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::BeginTooltip();
+				ImGui::Text(("Sorted Draws: " + std::to_string(m_DrawPackets)).c_str());
+				ImGui::Text(("State Changes Saved: " + std::to_string(m_StateChangesSaved)).c_str());
+				ImGui::Text(("Draw Calls Saved: " + std::to_string(m_DrawCallsSaved)).c_str());
+				ImGui::EndTooltip();
+			}
 			ImGui::SameLine();
 
 			//update framerate every 30 frames
@@ -1875,6 +1901,8 @@ namespace Ainan
 					ImGui::Text("Particle Count = ");
 					ImGui::SameLine();
 					ImGui::TextColored({ 0.0f, 1.0f, 0.0f, 1.0f }, std::to_string(ps->ActiveParticleCount).c_str());
+					ImGui::SameLine();
+					ImGui::Text(("   Pool Size = " + std::to_string(ps->GetParticlePoolSize())).c_str());
 					ImGui::Separator();
 				}
 
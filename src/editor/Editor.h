@@ -121,6 +121,10 @@ namespace Ainan {
 		int32_t m_AverageFPS = 0;
 		uint32_t m_GPUMemAllocated = 0;
 		int32_t m_DrawCalls = 0;
+		//draw sorting stats of the environment scene
+		uint32_t m_DrawPackets = 0;
+		int32_t m_StateChangesSaved = 0;
+		int32_t m_DrawCallsSaved = 0;
 		uint32_t FrameCounter = 0; //advances by 1 on every update iteration. when it reaches c_ApplicationFramerate, it goes back to 0.
 		std::mt19937 m_RandomNumberGenerator;
 	private:
@@ -10,9 +10,21 @@ extern "C"
 }
 
 #include "Editor.h"
+#include "Window.h"
+#include "BoundedQueue.h"
+#include "renderer/ColorConversion.h"
 
 namespace Ainan {
 
+	//frames being read back in video export, all but one are in flight on the gpu and the last is being converted
+	const uint32_t c_ExportReadbackSlotCount = 4;
+	//converted frames waiting to be encoded
+	const size_t c_ExportFramePoolSize = 4;
+	//encoded packets waiting to be written to the file
+	const size_t c_ExportPacketQueueSize = 32;
+	//the progress window is drawn at most this often (in seconds) so drawing it doesn't slow down the export
+	const double c_ExportProgressUpdateInterval = 0.1;
+
 	Exporter::Exporter() :
 		m_Camera(ProjectionMode::Orthographic, glm::mat4(1.0f), 16.0f / 9.0f)
 	{
@@ -44,7 +56,7 @@ namespace Ainan {
 			ExportVideo(editor);
 	}
 
-	void Exporter::DrawEnvToExportSurface(Environment& env)
+	void Exporter::DrawEnvToExportSurface(Environment& env, int32_t width)
 	{
 		m_Camera.SetAspectRatio(16.0f / 9.0f);
 
@@ -79,7 +91,6 @@ namespace Ainan {
 		desc.Blur = env.BlurEnabled;
 		desc.BlurRadius = env.BlurRadius;
 		Renderer::BeginScene(desc);
-		float width = 1920;
 		float height = width / desc.SceneCamera.GetAspectRatio();
 		m_RenderSurface.SetSize(glm::ivec2(width, std::round(height / 2.0f) * 2.0f));
 		m_RenderSurface.SurfaceFramebuffer.Bind();
@@ -88,7 +99,12 @@ namespace Ainan {
 		if (desc.SceneCamera.GetProjectionMode() == ProjectionMode::Perspective)
 			env.EnvSkybox.Draw(desc.SceneCamera);
 		for (pEnvironmentObject& obj : env.Objects)
-			obj->Draw();
+		{
+			EnvironmentObjectInterface* object = obj.get();
+			DrawKey key;
+			if (object->GetDrawKey(key))
+				Renderer::SubmitDrawPacket(key, [object]() { object->Draw(); });
+		}
 
 		Renderer::EndScene();
 	}
@@ -219,6 +235,61 @@ namespace Ainan {
 		ImGui::Text("Seconds");
 		ImGui::PopItemWidth();
 
+		ImGui::PushItemWidth(150);
+		ImGui::Text("Framerate: ");
+		ImGui::SameLine();
+		if (ImGui::DragInt("##Framerate", &VideoSettings.Framerate, 1, 1, 240, "%d fps"))
+			VideoSettings.Framerate = std::clamp(VideoSettings.Framerate, 1, 240);
+
+		ImGui::Text("Width: ");
+		ImGui::SameLine();
+		if (ImGui::DragInt("##Width", &VideoSettings.Width, 8, 256, 7680, "%d px"))
+			VideoSettings.Width = std::clamp(VideoSettings.Width, 256, 7680);
+
+		ImGui::Text("Supersampling: ");
+		ImGui::SameLine();
+		ImGui::SliderInt("##Supersampling", &VideoSettings.Supersampling, 1, 4, "%dx");
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::BeginTooltip();
+			ImGui::Text("Draws every frame bigger and shrinks it to the size of the video, this smooths edges but takes longer");
+			ImGui::EndTooltip();
+		}
+
+		if (VideoSettings.Supersampling > 1)
+		{
+			IMGUI_DROPDOWN_START("Downsample Filter", GetDownsampleFilterString(VideoSettings.Filter));
+			IMGUI_DROPDOWN_SELECTABLE(VideoSettings.Filter, DownsampleFilter::Box, GetDownsampleFilterString(DownsampleFilter::Box));
+			IMGUI_DROPDOWN_SELECTABLE(VideoSettings.Filter, DownsampleFilter::Lanczos, GetDownsampleFilterString(DownsampleFilter::Lanczos));
+			IMGUI_DROPDOWN_END();
+		}
+
+		IMGUI_DROPDOWN_START("Encoder Preset", GetEncoderPresetString(VideoSettings.Preset));
+		for (int32_t i = 0; i <= (int32_t)EncoderPreset::Veryslow; i++)
+			IMGUI_DROPDOWN_SELECTABLE(VideoSettings.Preset, (EncoderPreset)i, GetEncoderPresetString((EncoderPreset)i));
+		IMGUI_DROPDOWN_END();
+
+		IMGUI_DROPDOWN_START("Rate Control", GetRateControlModeString(VideoSettings.RateControl));
+		IMGUI_DROPDOWN_SELECTABLE(VideoSettings.RateControl, RateControlMode::ConstantQuality, GetRateControlModeString(RateControlMode::ConstantQuality));
+		IMGUI_DROPDOWN_SELECTABLE(VideoSettings.RateControl, RateControlMode::Bitrate, GetRateControlModeString(RateControlMode::Bitrate));
+		IMGUI_DROPDOWN_END();
+
+		if (VideoSettings.RateControl == RateControlMode::ConstantQuality)
+		{
+			ImGui::Text("CRF: ");
+			ImGui::SameLine();
+			if (ImGui::DragInt("##CRF", &VideoSettings.CRF, 0.2f, 0, 51))
+				VideoSettings.CRF = std::clamp(VideoSettings.CRF, 0, 51);
+		}
+		else
+		{
+			ImGui::Text("Bitrate: ");
+			ImGui::SameLine();
+			if (ImGui::DragInt("##Bitrate", &VideoSettings.BitrateKbps, 100, 100, 200000, "%d kbps"))
+				VideoSettings.BitrateKbps = std::clamp(VideoSettings.BitrateKbps, 100, 200000);
+		}
+		ImGui::PopItemWidth();
+
 		ImGui::TextColored({ 0.0f, 0.8f, 0.0f, 1.0f }, VideoSettings.ExportTargetLocation.GetSelectedSavePath().c_str());
 	}
 
@@ -282,12 +353,26 @@ namespace Ainan {
 		m_ExporterWindowOpen = true;
 	}
 
+	void Exporter::StepEnvironment(Environment& env, float deltaTime)
+	{
+		for (pEnvironmentObject& obj : env.Objects)
+		{
+			auto mutexPtr = obj->GetMutex();
+			std::lock_guard lock(*mutexPtr);
+			obj->Update(deltaTime);
+		}
+	}
+
 	void Exporter::ExportImage(Editor& editor)
 	{
+		//stopping first clears what was simulated in the editor so exporting the same environment always gives the same image
+		editor.Stop();
 		editor.PlayMode();
 
-		while (editor.m_TimeSincePlayModeStarted < ExportStartTime)
-			editor.Update();
+		const float timeStep = 1.0f / c_ApplicationFramerate;
+		const int32_t warmUpStepCount = GetWarmUpStepCount(c_ApplicationFramerate);
+		for (int32_t i = 0; i < warmUpStepCount; i++)
+			StepEnvironment(*editor.m_Env, timeStep);
 
 		DrawEnvToExportSurface(*editor.m_Env);
 		GetImageFromExportSurfaceToRAM();
@@ -304,15 +389,26 @@ namespace Ainan {
 		editor.Stop();
 	}
 
-#define CHECK(x) if((x) < 0) { AINAN_LOG_ERROR("Error while exporting video"); editor.Stop(); return; } 
-#define CHECKP(x) if((x) == 0) { AINAN_LOG_ERROR("Error while exporting video"); editor.Stop(); return; } 
+#define CHECK(x) if((x) < 0) { AINAN_LOG_ERROR("Error while exporting video"); return false; } 
+#define CHECKP(x) if((x) == 0) { AINAN_LOG_ERROR("Error while exporting video"); return false; } 
 
 	void Exporter::ExportVideo(Editor& editor)
 	{
+		//stopping first clears what was simulated in the editor so exporting the same environment always gives the same video
+		editor.Stop();
 		editor.PlayMode();
 
-		auto updateUI = [this, &editor](int32_t operationIndex, int32_t operationCount, float fraction)
+		double lastUIUpdateTime = 0.0;
+		auto updateUI = [this, &lastUIUpdateTime](int32_t operationIndex, int32_t operationCount, float fraction)
 		{
+			if (Window::GetTime() - lastUIUpdateTime < c_ExportProgressUpdateInterval)
+			{
+				//still send the commands so they don't pile up until the next time the window is drawn
+				Renderer::SubmitCommands();
+				return;
+			}
+			lastUIUpdateTime = Window::GetTime();
+
 			Renderer::SetRenderTargetApplicationWindow();
 			Renderer::ImGuiNewFrame();
 			ImGuiWrapper::BeginGlobalDocking(true);
@@ -322,16 +418,40 @@ namespace Ainan {
 			Renderer::Present();
 		};
 
-		while (editor.m_TimeSincePlayModeStarted < ExportStartTime)
+		ExportVideo(*editor.m_Env, VideoSettings.ExportTargetLocation.GetSelectedSavePath(), updateUI);
+		editor.Stop();
+	}
+
+	bool Exporter::ExportVideo(Environment& env, const std::string& path, const VideoExportProgressCallback& progress)
+	{
+		//the simulation moves exactly one frame of the video every exported frame and the export runs as fast as it can,
+		//so the video doesn't depend on how long the frames take to export
+		const int32_t framerate = VideoSettings.Framerate;
+		const float timeStep = 1.0f / framerate;
+		const int32_t totalFrameCount = framerate * (VideoSettings.LengthSeconds + 60 * VideoSettings.LengthMinutes);
+
+		//frame 0 is always drawn and the last pending frames are numbered from totalFrameCount, so there has to be at least one
+		if (totalFrameCount <= 0)
 		{
-			editor.Update();
-			updateUI(1, 2, editor.m_TimeSincePlayModeStarted / ExportStartTime);
+			AINAN_LOG_ERROR("Cannot export a video with no frames, set a length and a framerate above 0");
+			return false;
 		}
 
-		DrawEnvToExportSurface(*editor.m_Env);
-		GetImageFromExportSurfaceToRAM();
-		if (Renderer::Rdata->API == RendererType::OpenGL)
-			m_ExportTargetImage->FlipHorizontally();
+		const int32_t warmUpStepCount = GetWarmUpStepCount(framerate);
+		for (int32_t i = 0; i < warmUpStepCount; i++)
+		{
+			StepEnvironment(env, timeStep);
+			progress(1, 2, (float)i / warmUpStepCount);
+		}
+
+		const int32_t supersampling = std::clamp(VideoSettings.Supersampling, 1, std::max(1, c_MaxExportSurfaceWidth / VideoSettings.Width));
+		const int32_t surfaceWidth = VideoSettings.Width * supersampling;
+
+		//frames are read back through a ring of buffers so the gpu is never waited on right after drawing a frame
+		FramebufferReadback readback(c_ExportReadbackSlotCount);
+		DrawEnvToExportSurface(env, surfaceWidth);
+		readback.Start(m_RenderSurface.SurfaceFramebuffer);
+		const glm::vec2 surfaceSize = m_RenderSurface.SurfaceFramebuffer.GetSize();
 		const AVPixelFormat fmt = AV_PIX_FMT_YUV420P;
 
 		AVFormatContext* fContext = nullptr;
@@ -340,79 +460,260 @@ namespace Ainan {
 		AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_H264);
 		cContext = avcodec_alloc_context3(codec);
 		int32_t result = 0;
-		result = avformat_alloc_output_context2(&fContext, nullptr, nullptr, VideoSettings.ExportTargetLocation.GetSelectedSavePath().c_str());
+		result = avformat_alloc_output_context2(&fContext, nullptr, nullptr, path.c_str());
 		CHECK(result);
-		int32_t totalFrameCount = 60 * VideoSettings.LengthSeconds + 60 * VideoSettings.LengthSeconds * VideoSettings.LengthMinutes;
 		fContext->duration = totalFrameCount;
 
 		vStream = avformat_new_stream(fContext, codec);
-		vStream->codecpar->format = fmt;
-		vStream->codecpar->width = std::round(m_ExportTargetImage->m_Width / 2.0f) * 2;
-		vStream->codecpar->height = std::round(m_ExportTargetImage->m_Height / 2.0f) * 2;
-		vStream->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
-		vStream->codecpar->codec_id = AV_CODEC_ID_H264;
 		CHECKP(vStream);
 
 		result = avio_open(&fContext->pb, fContext->filename, AVIO_FLAG_WRITE);
 		CHECK(result);
 
-		cContext->width = vStream->codecpar->width;
-		cContext->height = vStream->codecpar->height;
+		//yuv420 needs even sizes, the surface is downsampled to this size while it's converted
+		cContext->width = std::round(surfaceSize.x / supersampling / 2.0f) * 2;
+		cContext->height = std::round(surfaceSize.y / supersampling / 2.0f) * 2;
 		cContext->pix_fmt = fmt;
-		cContext->framerate = AVRational{ 60,1 };
-		cContext->time_base = AVRational{ 1, 60 };
-
-		result = avcodec_open2(cContext, codec, 0);
+		cContext->framerate = AVRational{ framerate, 1 };
+		cContext->time_base = AVRational{ 1, framerate };
+		if (fContext->oformat->flags & AVFMT_GLOBALHEADER)
+			cContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+		AVDictionary* codecOptions = nullptr;
+		av_dict_set(&codecOptions, "preset", GetEncoderPresetString(VideoSettings.Preset), 0);
+		if (VideoSettings.RateControl == RateControlMode::ConstantQuality)
+			av_dict_set_int(&codecOptions, "crf", VideoSettings.CRF, 0);
+		else
+			cContext->bit_rate = (int64_t)VideoSettings.BitrateKbps * 1000;
+
+		result = avcodec_open2(cContext, codec, &codecOptions);
+		//options the encoder doesn't have are left in the dictionary and ignored, so h264 encoders other than x264 still work
+		av_dict_free(&codecOptions);
 		CHECK(result);
 
-		vStream->codec->width = cContext->width;
-		vStream->codec->height = cContext->height;
-		vStream->codec->pix_fmt = cContext->pix_fmt;
-		vStream->codec->framerate = cContext->framerate;
-		vStream->codec->time_base = cContext->time_base;
+		result = avcodec_parameters_from_context(vStream->codecpar, cContext);
+		CHECK(result);
+		vStream->time_base = cContext->time_base;
 
 		result = avformat_write_header(fContext, 0);
 		CHECK(result);
 
-		AVPacket* pkt = av_packet_alloc();
-		AVFrame* frame = av_frame_alloc();
-		SwsContext* swsContext = sws_getContext(cContext->width, cContext->height, AV_PIX_FMT_RGBA,
-			cContext->width, cContext->height, fmt, 0, 0, 0, 0);
-		CHECKP(swsContext);
-		frame->width = cContext->width;
-		frame->height = cContext->height;
-		frame->format = fmt;
-		frame->color_range = AVColorRange::AVCOL_RANGE_MPEG;
-		av_image_alloc(frame->data, frame->linesize, frame->width, frame->height, fmt, 1);
-		for (size_t i = 0; i < totalFrameCount; i++)
+		//frames the size of the video are converted with ColorConversion, which also flips them in the same pass.
+		//sws_scale is only used when the frames have to be downsampled too
+		SwsContext* swsContext = nullptr;
+		if (surfaceSize.x != cContext->width || surfaceSize.y != cContext->height)
+		{
+			//area averaging is a box filter when the surface is a whole number of times bigger than the video
+			const int32_t downsampleFlags = VideoSettings.Filter == DownsampleFilter::Box ? SWS_AREA : SWS_LANCZOS;
+			swsContext = sws_getContext((int32_t)surfaceSize.x, (int32_t)surfaceSize.y, AV_PIX_FMT_RGBA,
+				cContext->width, cContext->height, fmt, downsampleFlags, 0, 0, 0);
+			CHECKP(swsContext);
+		}
+
+		std::array<AVFrame*, c_ExportFramePoolSize> framePool;
+		for (AVFrame*& frame : framePool)
+		{
+			frame = av_frame_alloc();
+			frame->width = cContext->width;
+			frame->height = cContext->height;
+			frame->format = fmt;
+			frame->color_range = AVColorRange::AVCOL_RANGE_MPEG;
+			av_image_alloc(frame->data, frame->linesize, frame->width, frame->height, fmt, 1);
+		}
+
+		//the export is a pipeline where every stage runs on its own thread and passes its output to the next one through a queue:
+		//simulate, draw and read back (this thread) -> convert to yuv -> encode -> write to the file.
+		//the queues are bounded so a stage that is ahead waits for the slower stages, the export goes as fast as the slowest one
+		struct ConvertJob
+		{
+			FramebufferPixels Pixels;
+			int64_t FrameIndex;
+		};
+		BoundedQueue<ConvertJob> convertQueue(c_ExportReadbackSlotCount);
+		//a readback slot can only be reused after the frame in it is converted, the converter sends the index of every converted frame here
+		BoundedQueue<int64_t> convertedFrames(c_ExportReadbackSlotCount);
+		BoundedQueue<AVFrame*> freeFrames(c_ExportFramePoolSize);
+		BoundedQueue<AVFrame*> encodeQueue(c_ExportFramePoolSize);
+		BoundedQueue<AVPacket*> packetQueue(c_ExportPacketQueueSize);
+		for (AVFrame* frame : framePool)
+			freeFrames.Push(frame);
+
+		//closing every queue wakes up all the stages so they can stop
+		std::atomic_bool failed = false;
+		auto fail = [&]()
+		{
+			failed = true;
+			convertQueue.Close();
+			convertedFrames.Close();
+			freeFrames.Close();
+			encodeQueue.Close();
+			packetQueue.Close();
+		};
+
+		std::thread convertThread([&]()
+		{
+			ConvertJob job;
+			while (convertQueue.Pop(job))
+			{
+				AVFrame* frame = nullptr;
+				if (!freeFrames.Pop(frame))
+					return;
+
+				if (swsContext)
+				{
+					//OpenGL rows go from the bottom up, starting from the last row with a negative stride flips the image while converting it
+					const uint8_t* srcData[4] = { job.Pixels.Data, nullptr, nullptr, nullptr };
+					int32_t srcStride[4] = { (int32_t)job.Pixels.RowPitch, 0, 0, 0 };
+					if (job.Pixels.BottomUp)
+					{
+						srcData[0] = job.Pixels.Data + (size_t)(job.Pixels.Height - 1) * job.Pixels.RowPitch;
+						srcStride[0] = -(int32_t)job.Pixels.RowPitch;
+					}
+
+					if (sws_scale(swsContext, srcData, srcStride, 0, job.Pixels.Height, frame->data, frame->linesize) < 0)
+					{
+						fail();
+						return;
+					}
+				}
+				else
+				{
+					YUV420Image image;
+					for (int32_t i = 0; i < 3; i++)
+					{
+						image.Planes[i] = frame->data[i];
+						image.Strides[i] = frame->linesize[i];
+					}
+					ColorConversion::RGBAToYUV420(job.Pixels, image, true);
+				}
+				frame->pts = job.FrameIndex;
+
+				//this fails once the last frame is started and nothing waits for slots anymore, that's fine
+				convertedFrames.Push(job.FrameIndex);
+				if (!encodeQueue.Push(frame))
+					return;
+			}
+			encodeQueue.Close();
+		});
+
+		std::thread encodeThread([&]()
+		{
+			//returns false if the packets can't be sent to the muxer
+			auto receivePackets = [&]()
+			{
+				while (true)
+				{
+					AVPacket* packet = av_packet_alloc();
+					int32_t result = avcodec_receive_packet(cContext, packet);
+					if (result < 0)
+					{
+						av_packet_free(&packet);
+						return result == AVERROR(EAGAIN) || result == AVERROR_EOF;
+					}
+
+					av_packet_rescale_ts(packet, cContext->time_base, vStream->time_base);
+					packet->stream_index = vStream->index;
+					if (!packetQueue.Push(packet))
+					{
+						av_packet_free(&packet);
+						return false;
+					}
+				}
+			};
+
+			AVFrame* frame = nullptr;
+			while (encodeQueue.Pop(frame))
+			{
+				//the encoder copies frames it keeps, so the frame can be converted into again right away
+				int32_t result = avcodec_send_frame(cContext, frame);
+				freeFrames.Push(frame);
+				if (result < 0 || !receivePackets())
+				{
+					fail();
+					return;
+				}
+			}
+			if (failed)
+				return;
+
+			//get the frames the encoder held back for its lookahead
+			if (avcodec_send_frame(cContext, nullptr) < 0 || !receivePackets())
+			{
+				fail();
+				return;
+			}
+			packetQueue.Close();
+		});
+
+		std::thread muxThread([&]()
 		{
-			result = 0;
-			
-			frame->pts = av_rescale_q(i, cContext->time_base, vStream->time_base);
-			int rgba_stride[4] = { 4 * frame->width, 0, 0, 0 };
-			int dst_stride[4] = { frame->height, 0, 0, 0 };
-			int idk = av_image_get_buffer_size(AV_PIX_FMT_RGBA, frame->width, frame->height, 1);
-			result = sws_scale(swsContext, &m_ExportTargetImage->m_Data, rgba_stride, 0, frame->height, frame->data, frame->linesize);
-			CHECK(result);
-			result = avcodec_send_frame(cContext, frame);
-			CHECK(result);
-			result = avcodec_receive_packet(cContext, pkt);
-			if (result != -11)
+			AVPacket* packet = nullptr;
+			while (packetQueue.Pop(packet))
+			{
+				int32_t result = av_interleaved_write_frame(fContext, packet);
+				av_packet_free(&packet);
+				if (result < 0)
+				{
+					fail();
+					return;
+				}
+			}
+		});
+
+		//frame 0 was started above. a frame is collected c_ExportReadbackSlotCount - 1 frames after it's started, and prefetched
+		//one frame before that so the renderer thread waits for it while this thread simulates and draws the next frame
+		for (int64_t i = 1; i < totalFrameCount && !failed; i++)
+		{
+			StepEnvironment(env, timeStep);
+			DrawEnvToExportSurface(env, surfaceWidth);
+
+			if (readback.GetPendingCount() == c_ExportReadbackSlotCount - 1)
 			{
-				result = av_interleaved_write_frame(fContext, pkt);
+				int64_t frameIndex = i - readback.GetPendingCount();
+				if (!convertQueue.Push({ readback.Collect(), frameIndex }))
+					break;
 			}
-			editor.Update();
-			DrawEnvToExportSurface(*editor.m_Env);
-			GetImageFromExportSurfaceToRAM();
-			if (Renderer::Rdata->API == RendererType::OpenGL)
-				m_ExportTargetImage->FlipHorizontally();
-			updateUI(2, 2, (float)i / totalFrameCount);
+
+			//wait until the frame that was in the slot being reused is converted
+			int64_t convertedFrame = 0;
+			if (i >= c_ExportReadbackSlotCount && !convertedFrames.Pop(convertedFrame))
+				break;
+
+			readback.Start(m_RenderSurface.SurfaceFramebuffer);
+			if (readback.GetPendingCount() == c_ExportReadbackSlotCount - 1)
+				readback.Prefetch();
+			progress(2, 2, (float)i / totalFrameCount);
+		}
+
+		convertedFrames.Close();
+		while (readback.GetPendingCount() > 0 && !failed)
+		{
+			int64_t frameIndex = totalFrameCount - readback.GetPendingCount();
+			if (!convertQueue.Push({ readback.Collect(), frameIndex }))
+				break;
+		}
+		convertQueue.Close();
+
+		convertThread.join();
+		encodeThread.join();
+		muxThread.join();
+
+		for (AVFrame*& frame : framePool)
+		{
+			av_freep(&frame->data[0]);
+			av_frame_free(&frame);
 		}
-		av_packet_unref(pkt);
-		av_freep(&frame->data[0]);
-		av_frame_free(&frame);
 		sws_freeContext(swsContext);
 
+		if (failed)
+		{
+			AINAN_LOG_ERROR("Error while exporting video");
+			avio_close(fContext->pb);
+			avcodec_free_context(&cContext);
+			avformat_free_context(fContext);
+			return false;
+		}
+
 		result = av_write_trailer(fContext);
 		CHECK(result);
 
@@ -420,6 +721,6 @@ namespace Ainan {
 		avcodec_free_context(&cContext);
 		avformat_free_context(fContext);
 
-		editor.Stop();
+		return true;
 	}
 }
@@ -23,6 +23,38 @@ namespace Ainan {
 			Video
 		};
 	public:
+		static constexpr int32_t c_DefaultExportWidth = 1920;
+		//supersampled frames are kept under the biggest framebuffer size every gpu we support can make
+		static constexpr int32_t c_MaxExportSurfaceWidth = 16384;
+
+		enum class DownsampleFilter
+		{
+			Box,
+			Lanczos
+		};
+
+		//the x264 presets, slower presets make smaller files at the same quality
+		enum class EncoderPreset
+		{
+			Ultrafast,
+			Superfast,
+			Veryfast,
+			Faster,
+			Fast,
+			Medium,
+			Slow,
+			Slower,
+			Veryslow
+		};
+
+		enum class RateControlMode
+		{
+			//the quality stays the same and the size of the file depends on the content
+			ConstantQuality,
+			//the size of the file stays the same and the quality depends on the content
+			Bitrate
+		};
+
 		Exporter();
 		~Exporter();
 		void DisplayGUI(Environment& env);
@@ -30,7 +62,24 @@ namespace Ainan {
 
 		void ExportIfScheduled(Editor& editor);
 		void ExportImage(Editor& editor);
+		//exports the environment open in the editor and shows the progress in a window
 		void ExportVideo(Editor& editor);
+		//operation operationIndex of operationCount (simulating up to ExportStartTime, then exporting the frames) is fraction done.
+		//it's called after every simulated frame and has to submit the commands recorded for it, with Present or SubmitCommands
+		using VideoExportProgressCallback = std::function<void(int32_t operationIndex, int32_t operationCount, float fraction)>;
+		//exports a video of env to path with VideoSettings starting at ExportStartTime, the environment doesn't need to be open
+		//in the editor and ImGui isn't used, returns false if the video couldn't be exported
+		bool ExportVideo(Environment& env, const std::string& path, const VideoExportProgressCallback& progress);
+
+		//draws the environment through the export camera, the environment doesn't need to be open in the editor.
+		//the height of the surface follows the aspect ratio of the camera
+		void DrawEnvToExportSurface(Environment& env, int32_t width = c_DefaultExportWidth);
+		//updates every object of the environment by deltaTime on the calling thread. exports use this instead of Editor::Update,
+		//which uses the wall clock, so every exported frame moves the simulation by the same time no matter how long it took
+		static void StepEnvironment(Environment& env, float deltaTime);
+		//the number of steps of 1 / framerate seconds it takes to reach ExportStartTime
+		int32_t GetWarmUpStepCount(int32_t framerate) const { return (int32_t)std::round(ExportStartTime * framerate); }
+		void GetImageFromExportSurfaceToRAM();
 
 	public:
 		bool m_ExporterWindowOpen = false;
@@ -50,6 +99,16 @@ namespace Ainan {
 			int32_t Framerate = 60;
 			int32_t LengthMinutes = 0;
 			int32_t LengthSeconds = 5;
+			//the height follows the aspect ratio of the camera
+			int32_t Width = c_DefaultExportWidth;
+			//frames are drawn this many times bigger on each axis then downsampled to the size of the video
+			int32_t Supersampling = 1;
+			DownsampleFilter Filter = DownsampleFilter::Box;
+			EncoderPreset Preset = EncoderPreset::Medium;
+			RateControlMode RateControl = RateControlMode::ConstantQuality;
+			//0 is lossless and 51 is the worst, x264 uses 23 by default
+			int32_t CRF = 23;
+			int32_t BitrateKbps = 8000;
 		} VideoSettings;
 
 		struct ExportPictureSettings
@@ -62,8 +121,6 @@ namespace Ainan {
 		//this means after x seconds we will capture the frame using this exporter
 		float ExportStartTime = 5.0f;
 	private:
-		void DrawEnvToExportSurface(Environment& env);
-		void GetImageFromExportSurfaceToRAM();
 		void DisplayVideoExportSettingsControls();
 		void DisplayFinalizePictureExportSettingsWindow();
 		void DisplayProgressBarWindow(int32_t operationNum, int32_t operationCount, float fraction);
@@ -90,5 +147,72 @@ namespace Ainan {
 				return "";
 			}
 		}
+
+		static const char* GetDownsampleFilterString(DownsampleFilter filter)
+		{
+			switch (filter)
+			{
+			case DownsampleFilter::Box:
+				return "Box";
+
+			case DownsampleFilter::Lanczos:
+				return "Lanczos";
+
+			default:
+				return "";
+			}
+		}
+
+		//these are the names x264 uses for its presets
+		static const char* GetEncoderPresetString(EncoderPreset preset)
+		{
+			switch (preset)
+			{
+			case EncoderPreset::Ultrafast:
+				return "ultrafast";
+
+			case EncoderPreset::Superfast:
+				return "superfast";
+
+			case EncoderPreset::Veryfast:
+				return "veryfast";
+
+			case EncoderPreset::Faster:
+				return "faster";
+
+			case EncoderPreset::Fast:
+				return "fast";
+
+			case EncoderPreset::Medium:
+				return "medium";
+
+			case EncoderPreset::Slow:
+				return "slow";
+
+			case EncoderPreset::Slower:
+				return "slower";
+
+			case EncoderPreset::Veryslow:
+				return "veryslow";
+
+			default:
+				return "";
+			}
+		}
+
+		static const char* GetRateControlModeString(RateControlMode mode)
+		{
+			switch (mode)
+			{
+			case RateControlMode::ConstantQuality:
+				return "Constant Quality";
+
+			case RateControlMode::Bitrate:
+				return "Bitrate";
+
+			default:
+				return "";
+			}
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "HeadlessExport.h"
+
+#include "Editor.h" //for LoadEnvironment
+#include "file/AssetManager.h"
+
+namespace Ainan {
+
+	bool ParseHeadlessExportArguments(int argc, char** argv, HeadlessExportSettings& settings)
+	{
+		if (argc < 2 || std::string(argv[1]) != "--headless")
+			return false;
+
+		if (argc < 4)
+		{
+			std::cerr << c_HeadlessExportUsage << std::endl;
+			settings.ArgumentsValid = false;
+			return true;
+		}
+
+		settings.EnvironmentPath = argv[2];
+		settings.OutputPath = argv[3];
+
+		for (int i = 4; i < argc; i += 2)
+		{
+			std::string option = argv[i];
+			if (i + 1 == argc)
+			{
+				std::cerr << "Missing value for " << option << std::endl;
+				std::cerr << c_HeadlessExportUsage << std::endl;
+				settings.ArgumentsValid = false;
+				break;
+			}
+
+			try
+			{
+				if (option == "--capture-after")
+					settings.CaptureAfter = std::stof(argv[i + 1]);
+				else if (option == "--video")
+					settings.VideoLengthSeconds = std::stoi(argv[i + 1]);
+				else if (option == "--framerate")
+					settings.VideoFramerate = std::stoi(argv[i + 1]);
+				else if (option == "--benchmark")
+					settings.BenchmarkFrameCount = std::stoi(argv[i + 1]);
+				else
+					std::cerr << "Unknown option: " << option << std::endl;
+			}
+			catch (const std::logic_error&) //std::invalid_argument or std::out_of_range
+			{
+				std::cerr << "Invalid value for " << option << ": " << argv[i + 1] << std::endl;
+				std::cerr << c_HeadlessExportUsage << std::endl;
+				settings.ArgumentsValid = false;
+			}
+		}
+
+		return true;
+	}
+
+	int RunHeadlessExport(const HeadlessExportSettings& settings)
+	{
+		if (!std::filesystem::exists(settings.EnvironmentPath))
+		{
+			std::cerr << "Cannot find environment: " << settings.EnvironmentPath.u8string() << std::endl;
+			return 1;
+		}
+
+		Environment* env = LoadEnvironment(settings.EnvironmentPath.u8string());
+		int result = 0;
+
+		{
+			Exporter exporter;
+			for (pEnvironmentObject& obj : env->Objects)
+			{
+				if (obj->Type == CameraType)
+				{
+					exporter.ExportCameraID = obj->ID;
+					break;
+				}
+			}
+
+			if (env->FindObjectByID(exporter.ExportCameraID) == -1)
+			{
+				std::cerr << "The environment has no camera to export from" << std::endl;
+				result = 1;
+			}
+			else
+			{
+				Renderer::SetBlendMode(env->BlendMode);
+
+				const float timeStep = 1.0f / c_ApplicationFramerate;
+				exporter.ExportStartTime = settings.CaptureAfter;
+				if (settings.VideoLengthSeconds > 0)
+				{
+					exporter.VideoSettings.LengthSeconds = settings.VideoLengthSeconds;
+					exporter.VideoSettings.LengthMinutes = 0;
+					exporter.VideoSettings.Framerate = settings.VideoFramerate;
+
+					//there is no window to show the progress in, print every 10 percent of each operation instead
+					int32_t lastPrinted = -1;
+					auto printProgress = [&lastPrinted](int32_t operationIndex, int32_t operationCount, float fraction)
+					{
+						Renderer::SubmitCommands();
+
+						int32_t printed = (operationIndex - 1) * 10 + (int32_t)(fraction * 10.0f);
+						if (printed == lastPrinted)
+							return;
+						lastPrinted = printed;
+						std::cout << (operationIndex == 1 ? "Simulating to the start: " : "Exporting frames: ") <<
+							(int32_t)(fraction * 100.0f) << "%" << std::endl;
+					};
+
+					if (exporter.ExportVideo(*env, settings.OutputPath.u8string(), printProgress))
+						std::cout << "Exported " << settings.OutputPath.u8string() << std::endl;
+					else
+					{
+						std::cerr << "Cannot export video: " << settings.OutputPath.u8string() << std::endl;
+						result = 1;
+					}
+				}
+				else
+				{
+					const int32_t warmUpStepCount = exporter.GetWarmUpStepCount(c_ApplicationFramerate);
+					for (int32_t i = 0; i < warmUpStepCount; i++)
+						Exporter::StepEnvironment(*env, timeStep);
+
+					exporter.DrawEnvToExportSurface(*env);
+					exporter.GetImageFromExportSurfaceToRAM();
+					if (Renderer::Rdata->API == RendererType::OpenGL)
+						exporter.m_ExportTargetImage->FlipHorizontally();
+					//written on this thread, the app exits right after this and would stop a writer thread
+					if (exporter.m_ExportTargetImage->SaveToFile(settings.OutputPath.u8string(), ImageFormat::png, false))
+						std::cout << "Exported " << settings.OutputPath.u8string() << std::endl;
+					else
+					{
+						std::cerr << "Cannot write: " << settings.OutputPath.u8string() << std::endl;
+						result = 1;
+					}
+				}
+
+				if (result == 0 && settings.BenchmarkFrameCount > 0)
+				{
+					auto start = std::chrono::steady_clock::now();
+					for (int32_t i = 0; i < settings.BenchmarkFrameCount; i++)
+					{
+						Exporter::StepEnvironment(*env, timeStep);
+						exporter.DrawEnvToExportSurface(*env);
+						Renderer::Present();
+					}
+					Renderer::WaitUntilRendererIdle();
+					double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+					std::cout << "Benchmark: " << settings.BenchmarkFrameCount << " frames in " << seconds << "s, " <<
+						seconds * 1000.0 / settings.BenchmarkFrameCount << "ms per frame, " <<
+						settings.BenchmarkFrameCount / seconds << " fps" << std::endl;
+				}
+			}
+
+			Renderer::WaitUntilRendererIdle();
+		}
+
+		delete env;
+		AssetManager::Terminate();
+		return result;
+	}
+}
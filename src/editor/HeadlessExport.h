@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Exporter.h"
+
+namespace Ainan {
+
+	//exporting an environment from the command line without a window, so it can run on machines without a display.
+	//it exports a picture, or a video if --video is given, then optionally benchmarks more frames
+	constexpr const char* c_HeadlessExportUsage =
+		"Usage: Ainan --headless <environment .env file> <output .png or video file> [--capture-after <seconds>]\n"
+		"       [--video <length in seconds>] [--framerate <frames per second>] [--benchmark <frame count>]";
+
+	struct HeadlessExportSettings
+	{
+		std::filesystem::path EnvironmentPath;
+		std::filesystem::path OutputPath;
+		//the environment is simulated for this many seconds before the picture is taken, like Exporter::ExportStartTime
+		float CaptureAfter = 5.0f;
+		//if this isn't 0 a video this long that starts at CaptureAfter is exported instead of a picture,
+		//the format comes from the extension of OutputPath
+		int32_t VideoLengthSeconds = 0;
+		int32_t VideoFramerate = 60;
+		//if this isn't 0 this many more frames are simulated and drawn after the picture and the time they took is printed
+		int32_t BenchmarkFrameCount = 0;
+		//false if an option is missing its value or it isn't a number, the usage was already printed and nothing should be exported
+		bool ArgumentsValid = true;
+	};
+
+	//returns false if the arguments don't ask for a headless export
+	bool ParseHeadlessExportArguments(int argc, char** argv, HeadlessExportSettings& settings);
+
+	//the window and the renderer should be initialized in headless mode, returns the exit code of the app
+	int RunHeadlessExport(const HeadlessExportSettings& settings);
+}
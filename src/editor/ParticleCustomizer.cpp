@@ -5,7 +5,8 @@
 namespace Ainan {
 
 	ParticleCustomizer::ParticleCustomizer() :
-		mt(std::random_device{}())
+		m_Seed(std::random_device{}()),
+		m_Random(m_Seed)
 	{
 		VertexLayout layout(1);
 		layout[0] = VertexLayoutElement("POSITION", 0, ShaderVariableType::Vec3);
@@ -92,68 +93,98 @@ namespace Ainan {
 	{
 	}
 
-	ParticleDescription ParticleCustomizer::GetParticleDescription()
+	void ParticleCustomizer::GenerateParticles(const ParticleSpawnArrays& particles, size_t count)
 	{
-		ParticleDescription particleDesc = {};
+		//random numbers are generated for this many particles at a time
+		const size_t groupSize = 256;
+		float random[groupSize * c_RandomNumbersPerParticle];
 
-		switch (Mode)
-		{
-		case SpawnMode::SpawnOnPoint: 
-		{
-			particleDesc.Position = m_SpawnPosition;
-			break;
-		}
-
-		case SpawnMode::SpawnOnLine: 
-		{
-			std::uniform_real_distribution<float> dest(-1.0f, 1.0f);
-
-			float t = dest(mt);
-			float x = m_SpawnPosition.x + t * m_LineLength * cos(glm::radians(m_LineAngle));
-			float y = m_SpawnPosition.x + t * m_LineLength * sin(glm::radians(m_LineAngle));
-
-			particleDesc.Position = glm::vec2(x, y);
-			break;
-		}
-
-		case SpawnMode::SpawnOnCircle: 
-		{
-			//random angle between 0 and 2pi (360 degrees)
-			std::uniform_real_distribution<float> dest(0.0f, 2.0f * 3.14159f);
-			float angle = dest(mt);
+		glm::vec2 lineDirection = m_LineLength * glm::vec2(cos(glm::radians(m_LineAngle)), sin(glm::radians(m_LineAngle)));
 
-			float x = m_SpawnPosition.x + m_CircleRadius * cos(angle);
-			float y = m_SpawnPosition.y + m_CircleRadius * sin(angle);
-
-			particleDesc.Position = glm::vec2(x, y);
-			break;
-		}
-
-		case SpawnMode::SpawnInsideCircle: 
-		{
-			std::uniform_real_distribution<float> dest(0.0f, 1.0f);
-			float r = m_CircleRadius * sqrt(dest(mt));
-			float theta = dest(mt) * 2 * glm::pi<float>(); //in radians
-			particleDesc.Position = glm::vec2(m_SpawnPosition.x + r * cos(theta), m_SpawnPosition.y + r * sin(theta));
-			break;
-		}
-		}
-
-		particleDesc.Velocity = m_VelocityCustomizer.GetVelocity();
-		particleDesc.LifeTime = m_LifetimeCustomizer.GetLifetime();
-
-		//particleDesc.StartScale = m_ScaleCustomizer.GetScaleInterpolator().startPoint;
-		if (m_ScaleCustomizer.m_RandomScale)
+		for (size_t groupStart = 0; groupStart < count; groupStart += groupSize)
 		{
-			std::uniform_real_distribution<float> dest(m_ScaleCustomizer.m_MinScale, m_ScaleCustomizer.m_MaxScale);
-			particleDesc.StartScale = dest(mt);
+			size_t groupCount = std::min(groupSize, count - groupStart);
+
+			//every particle always takes the same amount of numbers, so that a particle gets the same numbers for
+			//the same seed no matter what the settings of the particles before it were
+			m_Random.NextFloats(random, groupCount * c_RandomNumbersPerParticle);
+
+			float* positionX = particles.PositionX + groupStart;
+			float* positionY = particles.PositionY + groupStart;
+
+			switch (Mode)
+			{
+			case SpawnMode::SpawnOnPoint:
+			{
+				for (size_t i = 0; i < groupCount; i++)
+				{
+					positionX[i] = m_SpawnPosition.x;
+					positionY[i] = m_SpawnPosition.y;
+				}
+				break;
+			}
+
+			case SpawnMode::SpawnOnLine:
+			{
+				for (size_t i = 0; i < groupCount; i++)
+				{
+					//random position on the line from -1 to 1
+					float t = random[i * c_RandomNumbersPerParticle] * 2.0f - 1.0f;
+					positionX[i] = m_SpawnPosition.x + t * lineDirection.x;
+					positionY[i] = m_SpawnPosition.y + t * lineDirection.y;
+				}
+				break;
+			}
+
+			case SpawnMode::SpawnOnCircle:
+			{
+				for (size_t i = 0; i < groupCount; i++)
+				{
+					//random angle between 0 and 2pi (360 degrees)
+					float angle = random[i * c_RandomNumbersPerParticle] * 2.0f * glm::pi<float>();
+					positionX[i] = m_SpawnPosition.x + m_CircleRadius * cos(angle);
+					positionY[i] = m_SpawnPosition.y + m_CircleRadius * sin(angle);
+				}
+				break;
+			}
+
+			case SpawnMode::SpawnInsideCircle:
+			{
+				for (size_t i = 0; i < groupCount; i++)
+				{
+					float r = m_CircleRadius * sqrt(random[i * c_RandomNumbersPerParticle]);
+					float theta = random[i * c_RandomNumbersPerParticle + 1] * 2 * glm::pi<float>(); //in radians
+					positionX[i] = m_SpawnPosition.x + r * cos(theta);
+					positionY[i] = m_SpawnPosition.y + r * sin(theta);
+				}
+				break;
+			}
+			}
+
+			for (size_t i = 0; i < groupCount; i++)
+			{
+				const float* particleRandom = random + i * c_RandomNumbersPerParticle;
+				size_t index = groupStart + i;
+
+				glm::vec2 velocity = m_VelocityCustomizer.GetVelocity(particleRandom[2], particleRandom[3]);
+				particles.VelocityX[index] = velocity.x;
+				particles.VelocityY[index] = velocity.y;
+				particles.AccelerationX[index] = 0.0f;
+				particles.AccelerationY[index] = 0.0f;
+
+				float lifeTime = m_LifetimeCustomizer.GetLifetime(particleRandom[4]);
+				particles.LifeTime[index] = lifeTime;
+				particles.RemainingLifeTime[index] = lifeTime;
+
+				if (m_ScaleCustomizer.m_RandomScale)
+					particles.StartScale[index] = m_ScaleCustomizer.m_MinScale + (m_ScaleCustomizer.m_MaxScale - m_ScaleCustomizer.m_MinScale) * particleRandom[5];
+				else
+					particles.StartScale[index] = m_ScaleCustomizer.m_DefinedScale;
+
+				particles.EndScale[index] = m_ScaleCustomizer.m_EndScale;
+				particles.NoiseOffset[index] = particleRandom[6] * c_MaxParticleNoiseOffset;
+			}
 		}
-		else
-			particleDesc.StartScale = m_ScaleCustomizer.m_DefinedScale;
-
-		particleDesc.EndScale = m_ScaleCustomizer.m_EndScale;
-
-		return particleDesc;
 	}
 
 	void ParticleCustomizer::DrawWorldSpaceUI()
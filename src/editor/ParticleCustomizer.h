@@ -8,11 +8,20 @@
 #include "customizers/LifetimeCustomizer.h"
 #include "customizers/NoiseCustomizer.h"
 #include "customizers/ForceCustomizer.h"
+#include "math/Random.h"
 
 namespace Ainan {
 
 	const glm::vec4 c_ParticleSpawnAreaColor = glm::vec4(0.0f, 0.7f, 0.0f, 0.85f);
 	const int32_t   c_CircleVertexCount = 60;
+	const int32_t   c_DefaultMaxParticleCount = 3000;
+	const int32_t   c_MaxParticleCountLimit = 2000000;
+	//every particle takes this many numbers from the random stream, whatever the settings are
+	const int32_t   c_RandomNumbersPerParticle = 8;
+	//particles sample the noise at their position plus a random offset between 0 and this
+	const float     c_MaxParticleNoiseOffset = 25600.0f;
+	const int32_t   c_MaxFixedStepsPerSecond = 1000;
+	const int32_t   c_MaxFixedStepsPerFrame = 32;
 
 	enum class SpawnMode 
 	{
@@ -22,14 +31,20 @@ namespace Ainan {
 		SpawnInsideCircle
 	};
 
-	struct ParticleDescription
+	//where GenerateParticles writes new particles, every pointer points to the first of the new particles
+	struct ParticleSpawnArrays
 	{
-		glm::vec2 Position;
-		glm::vec2 Velocity;
-		glm::vec2 Acceleration;
-		float StartScale;
-		float EndScale;
-		float LifeTime;
+		float* PositionX = nullptr;
+		float* PositionY = nullptr;
+		float* VelocityX = nullptr;
+		float* VelocityY = nullptr;
+		float* AccelerationX = nullptr;
+		float* AccelerationY = nullptr;
+		float* StartScale = nullptr;
+		float* EndScale = nullptr;
+		float* LifeTime = nullptr;
+		float* RemainingLifeTime = nullptr;
+		float* NoiseOffset = nullptr;
 	};
 
 	std::string GetModeAsText(const SpawnMode& mode);
@@ -42,17 +57,31 @@ namespace Ainan {
 		~ParticleCustomizer();
 
 		void DisplayGUI(const std::string& windowName);
-		ParticleDescription GetParticleDescription();
+		//writes count new particles to the arrays
+		void GenerateParticles(const ParticleSpawnArrays& particles, size_t count);
 
 		void DrawWorldSpaceUI();
 
 		float GetTimeBetweenParticles() { return 1 / m_ParticlesPerSecond; }
+		//restarts the random numbers from the start of the stream of m_Seed, so the same particles are spawned again
+		void ResetRandomStream() { m_Random.SetSeed(m_Seed); }
 
 	public:
 		SpawnMode Mode = SpawnMode::SpawnOnPoint;
 
 	public:
 		float m_ParticlesPerSecond = 100.0f;
+		//the pool of the particle system grows as needed but never holds more than this many particles
+		int32_t m_MaxParticleCount = c_DefaultMaxParticleCount;
+		//how many particles are spawned at once when a burst is requested
+		int32_t m_BurstCount = 1000;
+
+		//with a fixed time step the simulation advances in steps of 1 / m_FixedStepsPerSecond seconds,
+		//so the result doesn't depend on the frame rate
+		bool m_UseFixedTimeStep = false;
+		int32_t m_FixedStepsPerSecond = 60;
+		//limits the steps taken in one frame so a slow frame doesn't cause even slower frames after it
+		int32_t m_MaxStepsPerFrame = 8;
 
 		VelocityCustomizer m_VelocityCustomizer;
 		NoiseCustomizer m_NoiseCustomizer;
@@ -74,8 +103,9 @@ namespace Ainan {
 		UniformBuffer m_SpawnAreaColorUniformBuffer;
 		UniformBuffer m_CircleTransformUniformBuffer;
 
-		//random number generator
-		std::mt19937 mt;
+		//seed of the random numbers used for spawning, saved with the environment so simulations can be reproduced
+		uint32_t m_Seed = 0;
+		RandomStream m_Random;
 
 		friend class ParticleSystem;
 	};
@@ -15,6 +15,10 @@ namespace Ainan {
 	glm::vec2 Window::Size = { 0,0 };
 	glm::vec2 Window::Position = { 0,0 };
 	GLFWwindow* Window::Ptr = nullptr;
+	bool Window::Headless = false;
+
+	//glfw isn't initialized when there is no window, so headless mode keeps its own time
+	static std::chrono::steady_clock::time_point s_HeadlessStartTime;
 
 	static void framebuffer_size_callback(GLFWwindow* window, int32_t width, int32_t height)
 	{
@@ -111,14 +115,40 @@ namespace Ainan {
 		}
 	}
 
+	void Window::InitHeadless(const glm::vec2& framebufferSize)
+	{
+		Headless = true;
+		FramebufferSize = framebufferSize;
+		Size = framebufferSize;
+		WindowViewport.Width = framebufferSize.x;
+		WindowViewport.Height = framebufferSize.y;
+		s_HeadlessStartTime = std::chrono::steady_clock::now();
+
+#ifdef PLATFORM_WINDOWS
+		//windows always has a desktop, so a hidden window is the simplest way to get an OpenGL context
+		glfwInit();
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		Ptr = glfwCreateWindow(framebufferSize.x, framebufferSize.y, "Ainan", nullptr, nullptr);
+#endif // PLATFORM_WINDOWS
+	}
+
 	void Window::HandleWindowEvents()
 	{
+		if (Headless)
+			return;
+
 		glfwPollEvents();
 		ShouldClose = glfwWindowShouldClose(Ptr);
 	}
 
 	void Window::Terminate()
 	{
+		if (!Ptr)
+			return;
+
 		glfwDestroyWindow(Ptr);
 		glfwTerminate();
 	}
@@ -173,4 +203,12 @@ namespace Ainan {
 	{
 		return glfwGetWindowAttrib(Window::Ptr, GLFW_ICONIFIED);
 	}
+
+	double Window::GetTime()
+	{
+		if (Headless)
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - s_HeadlessStartTime).count();
+
+		return glfwGetTime();
+	}
 }
\ No newline at end of file
@@ -15,6 +15,9 @@ namespace Ainan {
 	{
 	public:
 		static void Init(RendererType api);
+		//for rendering without a display, nothing is shown and only framebuffers can be drawn to.
+		//on windows this makes a hidden window, on other platforms there is no window and OpenGL is used with EGL
+		static void InitHeadless(const glm::vec2& framebufferSize);
 		static void HandleWindowEvents();
 		static void Terminate();
 		static void CenterWindow();
@@ -27,6 +30,8 @@ namespace Ainan {
 		static void SetTitle(const std::string& title);
 
 		static bool IsIconified();
+		//seconds since the window was initialized
+		static double GetTime();
 	public:
 
 		//do NOT modify these ever, use Setxxx functions for that
@@ -38,6 +43,7 @@ namespace Ainan {
 		static glm::vec2 Position;
 		static bool WindowSizeChangedSinceLastFrame;
 		static Rectangle WindowViewport;
-		static GLFWwindow* Ptr;
+		static GLFWwindow* Ptr; //nullptr in headless mode on platforms other than windows
+		static bool Headless;
 	};
 }
\ No newline at end of file
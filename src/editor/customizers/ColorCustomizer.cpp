@@ -35,4 +35,16 @@ namespace Ainan {
 			ImGui::TreePop();
 		}
 	}
+
+	const CurveLUT& ColorCustomizer::GetCurveLUT()
+	{
+		if (m_CurveLUTBaked && m_BakedInterpolationType == m_InterpolationType)
+			return m_CurveLUT;
+
+		m_CurveLUT.Bake(m_InterpolationType);
+		m_CurveLUTBaked = true;
+		m_BakedInterpolationType = m_InterpolationType;
+
+		return m_CurveLUT;
+	}
 }
\ No newline at end of file
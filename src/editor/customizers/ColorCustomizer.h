@@ -2,6 +2,7 @@
 
 #include "editor/InterpolationSelector.h"
 #include "environment/ExposeToJson.h"
+#include "math/CurveLUT.h"
 
 namespace Ainan {
 
@@ -13,10 +14,17 @@ namespace Ainan {
 		glm::vec4 StartColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
 		glm::vec4 EndColor = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
 
+		//the color over time curve baked into a table, it's only baked again when the interpolation type changes
+		const CurveLUT& GetCurveLUT();
+
 	private:
 		//scale over time
 		InterpolationType m_InterpolationType = InterpolationType::Fixed;
 
+		CurveLUT m_CurveLUT;
+		bool m_CurveLUTBaked = false;
+		InterpolationType m_BakedInterpolationType = InterpolationType::Fixed;
+
 		EXPOSE_CUSTOMIZER_TO_JSON
 	};
 }
\ No newline at end of file
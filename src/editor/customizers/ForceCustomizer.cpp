@@ -77,6 +77,9 @@ namespace Ainan {
 				IMGUI_DROPDOWN_START_USING_COLUMNS("Force Type", Force::ForceTypeToString(m_Forces[m_CurrentSelectedForceName].Type));
 				IMGUI_DROPDOWN_SELECTABLE(m_Forces[m_CurrentSelectedForceName].Type, Force::DirectionalForce, Force::ForceTypeToString(Force::DirectionalForce));
 				IMGUI_DROPDOWN_SELECTABLE(m_Forces[m_CurrentSelectedForceName].Type, Force::RelativeForce, Force::ForceTypeToString(Force::RelativeForce));
+				IMGUI_DROPDOWN_SELECTABLE(m_Forces[m_CurrentSelectedForceName].Type, Force::SeparationForce, Force::ForceTypeToString(Force::SeparationForce));
+				IMGUI_DROPDOWN_SELECTABLE(m_Forces[m_CurrentSelectedForceName].Type, Force::CohesionForce, Force::ForceTypeToString(Force::CohesionForce));
+				IMGUI_DROPDOWN_SELECTABLE(m_Forces[m_CurrentSelectedForceName].Type, Force::AlignmentForce, Force::ForceTypeToString(Force::AlignmentForce));
 				IMGUI_DROPDOWN_END();
 
 				ImGui::NextColumn();
@@ -103,6 +106,18 @@ namespace Ainan {
 					ImGui::NextColumn();
 					ImGui::DragFloat("##Force Strength: ", &m_Forces[m_CurrentSelectedForceName].RF_Strength);
 				}
+				else if (Force::IsNeighborForce(m_Forces[m_CurrentSelectedForceName].Type))
+				{
+					ImGui::NextColumn();
+					ImGui::Text("Neighbor Radius: ");
+					ImGui::NextColumn();
+					ImGui::DragFloat("##Neighbor Radius: ", &m_Forces[m_CurrentSelectedForceName].NF_Radius, 0.001f, 0.001f, 1.0f);
+
+					ImGui::NextColumn();
+					ImGui::Text("Force Strength: ");
+					ImGui::NextColumn();
+					ImGui::DragFloat("##Neighbor Force Strength: ", &m_Forces[m_CurrentSelectedForceName].NF_Strength);
+				}
 			}
 
 			ImGui::NextColumn();
@@ -10,29 +10,25 @@ namespace Ainan {
 		enum ForceType 
 		{
 			DirectionalForce,	//as in only having a direction and magnitude and position has no effect on it
-			RelativeForce		//as in relative to some point in space
+			RelativeForce,		//as in relative to some point in space
+			SeparationForce,	//pushes particles away from the particles around them
+			CohesionForce,		//pulls particles towards the center of the particles around them
+			AlignmentForce		//steers particles towards the average velocity of the particles around them
 		};
 
-		glm::vec2 GetEffect(const glm::vec2& particlePos)
+		//neighbor forces depend on the other particles and can't be evaluated for one particle on its own
+		static constexpr bool IsNeighborForce(ForceType type)
 		{
-			if (Type == DirectionalForce)
-				return DF_Value;
-			else //it is a relative force
-			{
-				glm::vec2 dir = glm::normalize(RF_Target - particlePos);
-				
-				if (isnan(dir.x) || isnan(dir.y))
-					return glm::vec2(0.0f);
-
-				return RF_Strength * dir;
-			}
+			return type == SeparationForce || type == CohesionForce || type == AlignmentForce;
 		}
 
 		ForceType Type = DirectionalForce;
-		//DF stands for DirectionalForce and RF stands for RelativeForce
+		//DF stands for DirectionalForce, RF stands for RelativeForce and NF stands for NeighborForce
 		glm::vec2 DF_Value = { 0.0f,0.0f };  //ONLY USED IN DirectionalForce MODE
 		glm::vec2 RF_Target = { 0.45f,0.45f }; //ONLY USED IN RelativeForce MODE
 		float RF_Strength = 10.0f;			 //ONLY USED IN RelativeForce MODE
+		float NF_Radius = 0.05f;			 //ONLY USED IN Separation/Cohesion/Alignment MODES
+		float NF_Strength = 10.0f;			 //ONLY USED IN Separation/Cohesion/Alignment MODES
 
 		bool Enabled = false;
 
@@ -45,6 +41,12 @@ namespace Ainan {
 				return "Directional Force";
 			case RelativeForce:
 				return "Relative Force";
+			case SeparationForce:
+				return "Separation Force";
+			case CohesionForce:
+				return "Cohesion Force";
+			case AlignmentForce:
+				return "Alignment Force";
 			default:
 				AINAN_LOG_ERROR("Invalid force enum");
 				return "";
@@ -57,6 +59,12 @@ namespace Ainan {
 				return DirectionalForce;
 			else if (type == "Relative Force")
 				return RelativeForce;
+			else if (type == "Separation Force")
+				return SeparationForce;
+			else if (type == "Cohesion Force")
+				return CohesionForce;
+			else if (type == "Alignment Force")
+				return AlignmentForce;
 
 			//if we get here, that means there is an error
 			AINAN_LOG_ERROR("Invalid force type string");
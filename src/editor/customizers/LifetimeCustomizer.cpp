@@ -2,8 +2,7 @@
 
 namespace Ainan {
 
-	LifetimeCustomizer::LifetimeCustomizer() :
-		mt(std::random_device{}())
+	LifetimeCustomizer::LifetimeCustomizer()
 	{}
 
 	void LifetimeCustomizer::DisplayGUI()
@@ -54,12 +53,10 @@ namespace Ainan {
 			m_MinLifetime = m_MaxLifetime;
 	}
 
-	float LifetimeCustomizer::GetLifetime()
+	float LifetimeCustomizer::GetLifetime(float random)
 	{
-		if (m_RandomLifetime) {
-			std::uniform_real_distribution<float> dist_time(m_MinLifetime, m_MaxLifetime);
-			return dist_time(mt);
-		}
+		if (m_RandomLifetime)
+			return m_MinLifetime + (m_MaxLifetime - m_MinLifetime) * random;
 		else
 			return m_DefinedLifetime;
 	}
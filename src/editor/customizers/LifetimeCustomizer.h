@@ -10,7 +10,8 @@ namespace Ainan {
 		LifetimeCustomizer();
 		void DisplayGUI();
 
-		float GetLifetime();
+		//random is a uniform random number in [0, 1), it's only used if the lifetime is random
+		float GetLifetime(float random);
 
 	private:
 		bool m_RandomLifetime = true;
@@ -18,9 +19,6 @@ namespace Ainan {
 		float m_MinLifetime = 1.0f;
 		float m_MaxLifetime = 3.0f;
 
-		//random number generator
-		std::mt19937 mt;
-
 		EXPOSE_CUSTOMIZER_TO_JSON
 	};
 }
\ No newline at end of file
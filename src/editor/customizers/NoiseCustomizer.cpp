@@ -1,10 +1,21 @@
 #include "NoiseCustomizer.h"
 
+#include "math/SIMD.h"
+#include "ThreadPool.h"
+
 namespace Ainan {
 
 #define NOISE_TEXTURE_SIZE 256
 #define NOISE_WINDOW_INPUT_GUI_START_X 175.0f
 
+//FastNoise's perlin noise repeats every 256 units (the size of its permutation table),
+//so a field covering exactly one period can be tiled without any seams
+#define NOISE_FIELD_PERIOD 256
+#define NOISE_FIELD_SAMPLES_PER_UNIT 4
+#define NOISE_FIELD_SIZE (NOISE_FIELD_PERIOD * NOISE_FIELD_SAMPLES_PER_UNIT)
+//particles are processed in batches of this size so that temporary data stays on the stack
+#define NOISE_BATCH_SIZE 256
+
 	NoiseCustomizer::NoiseCustomizer()
 	{
 		NoisePreviewTexture = Renderer::CreateTexture(glm::vec2(NOISE_TEXTURE_SIZE, NOISE_TEXTURE_SIZE), TextureFormat::RGBA, TextureType::Texture2D, nullptr);
@@ -70,6 +81,13 @@ namespace Ainan {
 				}
 				ImGui::Spacing();
 
+				ImGui::NextColumn();
+				ImGui::Text("Precomputed Noise: ");
+				ImGui::NextColumn();
+				ImGui::Checkbox("##Precomputed Noise: ", &m_UseNoiseField);
+				if (ImGui::IsItemHovered())
+					ImGui::SetTooltip("Sample noise from a cached grid instead of calculating it for every particle.\nMuch faster with many particles but slightly less accurate");
+
 				ImGui::NextColumn();
 				ImGui::Text("Noise Preview: ");
 				ImGui::NextColumn();
@@ -82,36 +100,204 @@ namespace Ainan {
 		}
 	}
 
-	void NoiseCustomizer::ApplyNoise(glm::vec2& pos, glm::vec2& velocity, glm::vec2& acceleration, uint32_t index)
+	void NoiseCustomizer::PrepareNoise()
 	{
-		if (m_NoiseEnabled == false)
+		//these are set directly when loading an environment, so make sure the noise library uses them
+		NoiseLibrary.SetFrequency(m_NoiseFrequency);
+		NoiseLibrary.SetInterp(NoiseInterpolationMode);
+
+		if (m_NoiseEnabled == false || m_UseNoiseField == false)
 			return;
 
-		//this is so that the noise is different in every particle
-		glm::vec2 noiseInput = pos + (float)index * glm::vec2(100, 100);
+		if (m_NoiseField.empty() ||
+			m_NoiseFieldFrequency != m_NoiseFrequency ||
+			m_NoiseFieldInterpolationMode != NoiseInterpolationMode)
+			UpdateNoiseField();
+	}
 
+	void NoiseCustomizer::ApplyNoise(const ParticleArrays& particles, size_t begin, size_t end)
+	{
+		if (m_NoiseEnabled == false)
+			return;
+
+		//the target is resolved once here, so the loops below have no branches on it
 		switch (NoiseTarget)
 		{
 		case Add_To_Velocity:
-			velocity.x += GetNoise(noiseInput) * m_NoiseStrength;
-			velocity.y += GetNoise(-noiseInput) * m_NoiseStrength;
-			return;
+			ApplyNoiseToTarget<Add_To_Velocity>(particles, begin, end);
+			break;
 
 		case Add_To_Acceleration:
-			acceleration.x += GetNoise(noiseInput) * m_NoiseStrength;
-			acceleration.y += GetNoise(-noiseInput) * m_NoiseStrength;
-			return;
+			ApplyNoiseToTarget<Add_To_Acceleration>(particles, begin, end);
+			break;
+
+		case Set_Velocity_As_Noise:
+			ApplyNoiseToTarget<Set_Velocity_As_Noise>(particles, begin, end);
+			break;
+
+		case Set_Acceleration_As_Noise:
+			ApplyNoiseToTarget<Set_Acceleration_As_Noise>(particles, begin, end);
+			break;
+		}
+	}
+
+	template<NoiseCustomizer::NoiseApplyTarget target>
+	void NoiseCustomizer::ApplyNoiseToTarget(const ParticleArrays& particles, size_t begin, size_t end)
+	{
+		constexpr bool applyToVelocity = target == Add_To_Velocity || target == Set_Velocity_As_Noise;
+		constexpr bool addToTarget = target == Add_To_Velocity || target == Add_To_Acceleration;
+
+		float inputX[NOISE_BATCH_SIZE];
+		float inputY[NOISE_BATCH_SIZE];
+		float noiseX[NOISE_BATCH_SIZE];
+		float noiseY[NOISE_BATCH_SIZE];
+
+		for (size_t batchStart = begin; batchStart < end; batchStart += NOISE_BATCH_SIZE)
+		{
+			size_t count = std::min((size_t)NOISE_BATCH_SIZE, end - batchStart);
+
+			//this is so that the noise is different in every particle
+			for (size_t i = 0; i < count; i++)
+			{
+				float offset = particles.NoiseOffset[batchStart + i];
+				inputX[i] = particles.PositionX[batchStart + i] + offset;
+				inputY[i] = particles.PositionY[batchStart + i] + offset;
+			}
+
+			//x uses the noise at the input and y uses the noise at the negated input
+			SampleNoise(inputX, inputY, noiseX, count);
+			for (size_t i = 0; i < count; i++)
+			{
+				inputX[i] = -inputX[i];
+				inputY[i] = -inputY[i];
+			}
+			SampleNoise(inputX, inputY, noiseY, count);
+
+			float* targetX = (applyToVelocity ? particles.VelocityX : particles.AccelerationX) + batchStart;
+			float* targetY = (applyToVelocity ? particles.VelocityY : particles.AccelerationY) + batchStart;
+			for (size_t i = 0; i < count; i++)
+			{
+				if constexpr (addToTarget)
+				{
+					targetX[i] += noiseX[i] * m_NoiseStrength;
+					targetY[i] += noiseY[i] * m_NoiseStrength;
+				}
+				else
+				{
+					targetX[i] = noiseX[i] * m_NoiseStrength;
+					targetY[i] = noiseY[i] * m_NoiseStrength;
+				}
+			}
+		}
+	}
+
+#if AINAN_SIMD_X86
+	//bilinear lookups of 8 points at a time using AVX2 gathers
+	AINAN_TARGET_AVX2
+	static size_t SampleNoiseFieldAVX2(const float* field, float scale, const float* x, const float* y, float* result, size_t count)
+	{
+		const __m256 scaleVec = _mm256_set1_ps(scale);
+		const __m256i mask = _mm256_set1_epi32(NOISE_FIELD_SIZE - 1);
+		const __m256i one = _mm256_set1_epi32(1);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 gx = _mm256_mul_ps(_mm256_loadu_ps(x + i), scaleVec);
+			__m256 gy = _mm256_mul_ps(_mm256_loadu_ps(y + i), scaleVec);
+			__m256 floorX = _mm256_floor_ps(gx);
+			__m256 floorY = _mm256_floor_ps(gy);
+			__m256 tx = _mm256_sub_ps(gx, floorX);
+			__m256 ty = _mm256_sub_ps(gy, floorY);
 
-		case Ainan::NoiseCustomizer::Set_Velocity_As_Noise:
-			velocity.x = GetNoise(noiseInput) * m_NoiseStrength;
-			velocity.y = GetNoise(-noiseInput) * m_NoiseStrength;
+			__m256i x0 = _mm256_and_si256(_mm256_cvttps_epi32(floorX), mask);
+			__m256i y0 = _mm256_and_si256(_mm256_cvttps_epi32(floorY), mask);
+			__m256i x1 = _mm256_and_si256(_mm256_add_epi32(x0, one), mask);
+			__m256i y1 = _mm256_and_si256(_mm256_add_epi32(y0, one), mask);
+			__m256i row0 = _mm256_slli_epi32(y0, 10);
+			__m256i row1 = _mm256_slli_epi32(y1, 10);
+
+			__m256 v00 = _mm256_i32gather_ps(field, _mm256_add_epi32(row0, x0), 4);
+			__m256 v10 = _mm256_i32gather_ps(field, _mm256_add_epi32(row0, x1), 4);
+			__m256 v01 = _mm256_i32gather_ps(field, _mm256_add_epi32(row1, x0), 4);
+			__m256 v11 = _mm256_i32gather_ps(field, _mm256_add_epi32(row1, x1), 4);
+
+			__m256 top = _mm256_add_ps(v00, _mm256_mul_ps(_mm256_sub_ps(v10, v00), tx));
+			__m256 bottom = _mm256_add_ps(v01, _mm256_mul_ps(_mm256_sub_ps(v11, v01), tx));
+			_mm256_storeu_ps(result + i, _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(bottom, top), ty)));
+		}
+
+		return i;
+	}
+#endif
+
+	void NoiseCustomizer::SampleNoise(const float* x, const float* y, float* result, size_t count)
+	{
+		if (m_UseNoiseField == false || m_NoiseField.empty())
+		{
+			for (size_t i = 0; i < count; i++)
+				result[i] = NoiseLibrary.GetNoise(x[i], y[i]);
 			return;
+		}
+
+		const float* field = m_NoiseField.data();
+		const float scale = m_NoiseFieldFrequency * NOISE_FIELD_SAMPLES_PER_UNIT;
+
+		size_t i = 0;
+#if AINAN_SIMD_X86
+		static_assert(NOISE_FIELD_SIZE == 1 << 10, "the AVX2 path assumes 1024 samples per row");
+		if (GetSIMDLevel() >= SIMDLevel::AVX2)
+			i = SampleNoiseFieldAVX2(field, scale, x, y, result, count);
+#endif
+
+		//the field size is a power of 2 so wrapping around it is just a mask (which also works for negative coordinates)
+		for (; i < count; i++)
+		{
+			float gx = x[i] * scale;
+			float gy = y[i] * scale;
+			float floorX = std::floor(gx);
+			float floorY = std::floor(gy);
+			float tx = gx - floorX;
+			float ty = gy - floorY;
+
+			int32_t x0 = (int32_t)floorX & (NOISE_FIELD_SIZE - 1);
+			int32_t y0 = (int32_t)floorY & (NOISE_FIELD_SIZE - 1);
+			int32_t x1 = (x0 + 1) & (NOISE_FIELD_SIZE - 1);
+			int32_t y1 = (y0 + 1) & (NOISE_FIELD_SIZE - 1);
+
+			float v00 = field[y0 * NOISE_FIELD_SIZE + x0];
+			float v10 = field[y0 * NOISE_FIELD_SIZE + x1];
+			float v01 = field[y1 * NOISE_FIELD_SIZE + x0];
+			float v11 = field[y1 * NOISE_FIELD_SIZE + x1];
+
+			float top = v00 + (v10 - v00) * tx;
+			float bottom = v01 + (v11 - v01) * tx;
+			result[i] = top + (bottom - top) * ty;
+		}
+	}
+
+	void NoiseCustomizer::UpdateNoiseField()
+	{
+		m_NoiseFieldFrequency = m_NoiseFrequency;
+		m_NoiseFieldInterpolationMode = NoiseInterpolationMode;
+		m_NoiseField.resize(NOISE_FIELD_SIZE * NOISE_FIELD_SIZE);
 
-		case Ainan::NoiseCustomizer::Set_Acceleration_As_Noise:
-			acceleration.x = GetNoise(noiseInput) * m_NoiseStrength;
-			acceleration.y = GetNoise(-noiseInput) * m_NoiseStrength;
+		//perlin noise is 0 on every integer point, and with a frequency of 0 every input ends up on (0,0)
+		if (m_NoiseFieldFrequency <= 0.0f)
+		{
+			std::fill(m_NoiseField.begin(), m_NoiseField.end(), 0.0f);
 			return;
 		}
+
+		//distance between samples in input space, FastNoise multiplies the input by the frequency
+		float step = 1.0f / (m_NoiseFieldFrequency * NOISE_FIELD_SAMPLES_PER_UNIT);
+
+		ThreadPool::ParallelFor(NOISE_FIELD_SIZE, 32, [this, step](size_t begin, size_t end)
+			{
+				for (size_t y = begin; y < end; y++)
+					for (size_t x = 0; x < NOISE_FIELD_SIZE; x++)
+						m_NoiseField[y * NOISE_FIELD_SIZE + x] = NoiseLibrary.GetNoise(x * step, y * step);
+			});
 	}
 
 	float NoiseCustomizer::GetNoise(const glm::vec2& pos)
@@ -3,6 +3,7 @@
 #include "environment/ExposeToJson.h"
 
 #include "renderer/Renderer.h"
+#include "environment/ParticleKernels.h"
 #include "../submodules/FastNoise/FastNoise.h"
 
 namespace Ainan {
@@ -14,8 +15,14 @@ namespace Ainan {
 		~NoiseCustomizer();
 		void DisplayGUI();
 
-		void ApplyNoise(glm::vec2& pos, glm::vec2& velocity, glm::vec2& acceleration, uint32_t index = 0);
+		//syncs the noise settings and rebuilds the precomputed noise field if they changed.
+		//must be called (from one thread) before ApplyNoise every frame
+		void PrepareNoise();
+		//applies noise to the particles in [begin, end), the noise offset of each particle is used so that every particle gets different noise.
+		//this only reads the customizer so it can run on multiple ranges at the same time
+		void ApplyNoise(const ParticleArrays& particles, size_t begin, size_t end);
 		float GetNoise(const glm::vec2& pos);
+		bool IsEnabled() const { return m_NoiseEnabled; }
 
 		enum NoiseApplyTarget
 		{
@@ -89,6 +96,11 @@ namespace Ainan {
 
 	private:
 		void UpdateNoiseTex();
+		void UpdateNoiseField();
+		template<NoiseApplyTarget target>
+		void ApplyNoiseToTarget(const ParticleArrays& particles, size_t begin, size_t end);
+		//writes the noise at (x[i], y[i]) into result[i]
+		void SampleNoise(const float* x, const float* y, float* result, size_t count);
 
 	private:
 		bool m_NoiseEnabled = false;
@@ -98,6 +110,13 @@ namespace Ainan {
 		FastNoise::Interp NoiseInterpolationMode = FastNoise::Interp::Quintic;
 		FastNoise NoiseLibrary;
 
+		//instead of evaluating perlin noise for every particle, sample it from a grid that is only
+		//computed when the frequency or the interpolation mode changes
+		bool m_UseNoiseField = false;
+		std::vector<float> m_NoiseField;
+		float m_NoiseFieldFrequency = 0.0f;
+		FastNoise::Interp m_NoiseFieldInterpolationMode = FastNoise::Interp::Quintic;
+
 		EXPOSE_CUSTOMIZER_TO_JSON
 	};
 }
\ No newline at end of file
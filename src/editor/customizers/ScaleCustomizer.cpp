@@ -79,4 +79,27 @@ namespace Ainan {
 			ImGui::TreePop();
 		}
 	}
+
+	const CurveLUT& ScaleCustomizer::GetCurveLUT()
+	{
+		bool curveChanged = m_BakedCurve.StartPoint != m_Curve.CustomCurve.StartPoint ||
+			m_BakedCurve.EndPoint != m_Curve.CustomCurve.EndPoint ||
+			m_BakedCurve.ControlPoint1 != m_Curve.CustomCurve.ControlPoint1 ||
+			m_BakedCurve.ControlPoint2 != m_Curve.CustomCurve.ControlPoint2;
+
+		if (m_CurveLUTBaked && m_BakedInterpolationType == m_InterpolationType &&
+			(m_InterpolationType != Custom || !curveChanged))
+			return m_CurveLUT;
+
+		if (m_InterpolationType == Custom)
+			m_CurveLUT.Bake([this](float t) { return m_Curve.Interpolate(0.0f, 1.0f, t); });
+		else
+			m_CurveLUT.Bake(m_InterpolationType);
+
+		m_CurveLUTBaked = true;
+		m_BakedInterpolationType = m_InterpolationType;
+		m_BakedCurve = m_Curve.CustomCurve;
+
+		return m_CurveLUT;
+	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "editor/InterpolationSelector.h"
 #include "editor/CurveEditor.h"
 #include "environment/ExposeToJson.h"
+#include "math/CurveLUT.h"
 
 namespace Ainan {
 
@@ -23,7 +24,15 @@ namespace Ainan {
 		InterpolationType m_InterpolationType = InterpolationType::Linear;
 		float m_EndScale = m_DefinedScale;
 
+		//the scale over time curve baked into a table, it's only baked again when the curve changes
+		const CurveLUT& GetCurveLUT();
+
 	private:
+		CurveLUT m_CurveLUT;
+		bool m_CurveLUTBaked = false;
+		//what m_CurveLUT was baked from
+		InterpolationType m_BakedInterpolationType = InterpolationType::Linear;
+		BezierCurve m_BakedCurve = {};
 
 		EXPOSE_CUSTOMIZER_TO_JSON
 	};
@@ -11,6 +11,8 @@ namespace Ainan {
 	{
 		if (ParticleTexture.IsValid())
 			Renderer::DestroyTexture(ParticleTexture);
+		if (!ParticleTextureAtlasName.empty())
+			Renderer::RemoveFromTextureAtlas(ParticleTextureAtlasName);
 	}
 
 	TextureCustomizer::TextureCustomizer(const TextureCustomizer& customizer)
@@ -19,7 +21,7 @@ namespace Ainan {
 
 		if (!UseDefaultTexture)
 		{
-			ParticleTexture = Renderer::CreateTexture(Image::LoadFromFile(AssetManager::s_EnvironmentDirectory.u8string() + "\\" + customizer.m_TexturePath.u8string()));
+			LoadTexture(AssetManager::s_EnvironmentDirectory.u8string() + "\\" + customizer.m_TexturePath.u8string());
 		}
 	}
 
@@ -53,7 +55,7 @@ namespace Ainan {
 					{
 						if (textureFileName != "Default") 
 						{
-							ParticleTexture = Renderer::CreateTexture(Image::LoadFromFile(tex.u8string()));
+							LoadTexture(tex);
 							
 							UseDefaultTexture = false;
 							m_TexturePath = tex.lexically_relative(AssetManager::s_EnvironmentDirectory).u8string();
@@ -69,12 +71,41 @@ namespace Ainan {
 				ImGui::NextColumn();
 				ImGui::Text("Texture Preview: ");
 				ImGui::NextColumn();
-				if (ParticleTexture.IsValid())
-					ImGui::Image((void*)ParticleTexture.GetTextureID(), ImVec2(100, 100), ImVec2(0, 0), ImVec2(1, 1), ImVec4(1, 1, 1, 1), ImVec4(1, 1, 1, 1));
+				if (ParticleTextureRegion.IsValid())
+					ImGui::Image((void*)ParticleTextureRegion.Page.GetTextureID(), ImVec2(100, 100),
+						ImVec2(ParticleTextureRegion.UVMin.x, ParticleTextureRegion.UVMin.y), ImVec2(ParticleTextureRegion.UVMax.x, ParticleTextureRegion.UVMax.y),
+						ImVec4(1, 1, 1, 1), ImVec4(1, 1, 1, 1));
 			}
 
 			ImGui::NextColumn();
 			ImGui::TreePop();
 		}
 	}
+
+	void TextureCustomizer::LoadTexture(const std::filesystem::path& path)
+	{
+		if (ParticleTexture.IsValid())
+		{
+			Renderer::DestroyTexture(ParticleTexture);
+			ParticleTexture = Texture();
+		}
+		if (!ParticleTextureAtlasName.empty())
+		{
+			Renderer::RemoveFromTextureAtlas(ParticleTextureAtlasName);
+			ParticleTextureAtlasName.clear();
+		}
+
+		Image img = Image::LoadFromFile(path.u8string(), TextureFormat::RGBA);
+
+		std::string atlasName = TextureAtlas::GetImageName(path);
+		ParticleTextureRegion = Renderer::AddToTextureAtlas(atlasName, img);
+		if (ParticleTextureRegion.IsValid())
+			ParticleTextureAtlasName = atlasName;
+		else
+		{
+			ParticleTexture = Renderer::CreateTexture(img);
+			ParticleTextureRegion = AtlasRegion();
+			ParticleTextureRegion.Page = ParticleTexture;
+		}
+	}
 }
\ No newline at end of file
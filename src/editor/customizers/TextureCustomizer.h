@@ -17,10 +17,15 @@ namespace Ainan {
 		TextureCustomizer operator=(const TextureCustomizer& customizer);
 
 		void DisplayGUI();
+		//puts the image in the texture atlas, or in ParticleTexture if it's too big for the atlas
+		void LoadTexture(const std::filesystem::path& path);
 
 	public:
 		bool UseDefaultTexture = true;
+		AtlasRegion ParticleTextureRegion;
 		Texture ParticleTexture;
+		//the name ParticleTextureRegion was added to the atlas with, empty if it isn't in the atlas
+		std::string ParticleTextureAtlasName;
 		std::filesystem::path m_TexturePath = ""; //relative to the environment folder
 
 		EXPOSE_CUSTOMIZER_TO_JSON
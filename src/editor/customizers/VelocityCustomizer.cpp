@@ -32,8 +32,7 @@ namespace Ainan {
 		return VelocityCustomizer::NoLimit;
 	}
 
-	VelocityCustomizer::VelocityCustomizer() :
-		mt(std::random_device{}())
+	VelocityCustomizer::VelocityCustomizer()
 	{}
 
 	void VelocityCustomizer::DisplayGUI()
@@ -121,7 +120,7 @@ namespace Ainan {
 		}
 	}
 
-	glm::vec2 VelocityCustomizer::GetVelocity()
+	glm::vec2 VelocityCustomizer::GetVelocity(float randomX, float randomY)
 	{
 
 		if (m_RandomVelocity) {
@@ -130,9 +129,7 @@ namespace Ainan {
 			if (m_MinVelocity.y > m_MaxVelocity.y)
 				m_MinVelocity.y = m_MaxVelocity.y;
 
-			std::uniform_real_distribution<float> dist_velocity_x(m_MinVelocity.x, m_MaxVelocity.x);
-			std::uniform_real_distribution<float> dist_velocity_y(m_MinVelocity.y, m_MaxVelocity.y);
-			return glm::vec2(dist_velocity_x(mt), dist_velocity_y(mt));
+			return m_MinVelocity + (m_MaxVelocity - m_MinVelocity) * glm::vec2(randomX, randomY);
 		}
 		else
 			return m_DefinedVelocity;
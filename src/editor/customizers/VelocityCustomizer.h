@@ -17,7 +17,8 @@ namespace Ainan {
 		VelocityCustomizer();
 		void DisplayGUI();
 
-		glm::vec2 GetVelocity();
+		//randomX and randomY are uniform random numbers in [0, 1), they are only used if the velocity is random
+		glm::vec2 GetVelocity(float randomX, float randomY);
 
 		VelocityLimitType CurrentVelocityLimitType = NoLimit;
 	private:
@@ -38,9 +39,6 @@ namespace Ainan {
 		glm::vec2 m_MaxPerAxisVelocityLimit = { 1.0f, 1.0f };
 		//-------------------------------------
 
-		//random number generator
-		std::mt19937 mt;
-
 		EXPOSE_CUSTOMIZER_TO_JSON
 	};
 
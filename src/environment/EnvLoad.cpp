@@ -121,6 +121,24 @@ namespace Ainan {
 		ps->m_Name = data[id + "Name"].get<std::string>();
 		ps->Customizer.Mode = GetTextAsMode(data[id + "Mode"].get<std::string>());
 		ps->Customizer.m_ParticlesPerSecond = data[id + "ParticlesPerSecond"].get<float>();
+		//older environments don't have a particle limit saved, so they keep the default one
+		if (data.contains(id + "MaxParticleCount"))
+			ps->Customizer.m_MaxParticleCount = data[id + "MaxParticleCount"].get<int32_t>();
+		if (data.contains(id + "BurstCount"))
+			ps->Customizer.m_BurstCount = data[id + "BurstCount"].get<int32_t>();
+		if (data.contains(id + "UseFixedTimeStep"))
+		{
+			ps->Customizer.m_UseFixedTimeStep = data[id + "UseFixedTimeStep"].get<bool>();
+			//clamped to the ranges the customizer allows, a 0 would divide by zero in the step time and a huge
+			//step count would stall every frame, the file can be edited by hand
+			ps->Customizer.m_FixedStepsPerSecond = std::clamp(data[id + "FixedStepsPerSecond"].get<int32_t>(), 1, c_MaxFixedStepsPerSecond);
+			ps->Customizer.m_MaxStepsPerFrame = std::clamp(data[id + "MaxStepsPerFrame"].get<int32_t>(), 1, c_MaxFixedStepsPerFrame);
+		}
+		if (data.contains(id + "Seed"))
+		{
+			ps->Customizer.m_Seed = data[id + "Seed"].get<uint32_t>();
+			ps->Customizer.ResetRandomStream();
+		}
 		ps->Customizer.m_SpawnPosition = JSON_ARRAY_TO_VEC2(data[id + "SpawnPosition"].get<std::vector<float>>());
 		ps->Customizer.m_LineLength = data[id + "LineLength"].get<float>();
 		ps->Customizer.m_LineAngle = data[id + "LineAngle"].get<float>();
@@ -162,13 +180,15 @@ namespace Ainan {
 		ps->Customizer.m_NoiseCustomizer.m_NoiseFrequency = data[id + "NoiseFrequency"].get<float>();
 		ps->Customizer.m_NoiseCustomizer.NoiseTarget = NoiseCustomizer::NoiseApplyTargetVal(data[id + "NoiseTarget"].get<std::string>());
 		ps->Customizer.m_NoiseCustomizer.NoiseInterpolationMode = NoiseCustomizer::NoiseInterpolationModeVal(data[id + "NoiseInterpolationMode"].get<std::string>());
+		if (data.contains(id + "NoiseUsePrecomputedField"))
+			ps->Customizer.m_NoiseCustomizer.m_UseNoiseField = data[id + "NoiseUsePrecomputedField"].get<bool>();
 
 		//Texture data
 		ps->Customizer.m_TextureCustomizer.UseDefaultTexture = data[id + "UseDefaultTexture"].get<bool>();
 		ps->Customizer.m_TextureCustomizer.m_TexturePath = data[id + "TexturePath"].get<std::string>();
 		if (!ps->Customizer.m_TextureCustomizer.UseDefaultTexture)
 		{
-			ps->Customizer.m_TextureCustomizer.ParticleTexture = Renderer::CreateTexture(Image::LoadFromFile(AssetManager::s_EnvironmentDirectory.u8string() + "\\" + ps->Customizer.m_TextureCustomizer.m_TexturePath.u8string()));
+			ps->Customizer.m_TextureCustomizer.LoadTexture(AssetManager::s_EnvironmentDirectory.u8string() + "\\" + ps->Customizer.m_TextureCustomizer.m_TexturePath.u8string());
 		}
 
 		//Force data
@@ -189,6 +209,11 @@ namespace Ainan {
 			currentForce.DF_Value = JSON_ARRAY_TO_VEC2(data[id + "Force" + std::to_string(i).c_str() + "DF_Value"].get<std::vector<float>>());
 			currentForce.RF_Target = JSON_ARRAY_TO_VEC2(data[id + "Force" + std::to_string(i).c_str() + "RF_Target"].get<std::vector<float>>());
 			currentForce.RF_Strength = data[id + "Force" + std::to_string(i).c_str() + "RF_Strength"].get<float>();
+			if (data.contains(id + "Force" + std::to_string(i).c_str() + "NF_Radius"))
+			{
+				currentForce.NF_Radius = data[id + "Force" + std::to_string(i).c_str() + "NF_Radius"].get<float>();
+				currentForce.NF_Strength = data[id + "Force" + std::to_string(i).c_str() + "NF_Strength"].get<float>();
+			}
 		}
 		
 		//add particle system to environment
@@ -113,6 +113,12 @@ namespace Ainan {
 		j[id + "Name"] = ps.m_Name;
 		j[id + "Mode"] = GetModeAsText(ps.Customizer.Mode);
 		j[id + "ParticlesPerSecond"] = ps.Customizer.m_ParticlesPerSecond;
+		j[id + "MaxParticleCount"] = ps.Customizer.m_MaxParticleCount;
+		j[id + "Seed"] = ps.Customizer.m_Seed;
+		j[id + "BurstCount"] = ps.Customizer.m_BurstCount;
+		j[id + "UseFixedTimeStep"] = ps.Customizer.m_UseFixedTimeStep;
+		j[id + "FixedStepsPerSecond"] = ps.Customizer.m_FixedStepsPerSecond;
+		j[id + "MaxStepsPerFrame"] = ps.Customizer.m_MaxStepsPerFrame;
 		j[id + "SpawnPosition"] = VEC2_TO_JSON_ARRAY(ps.Customizer.m_SpawnPosition);
 		j[id + "LineLength"] = ps.Customizer.m_LineLength;
 		j[id + "LineAngle"] = ps.Customizer.m_LineAngle;
@@ -154,6 +160,7 @@ namespace Ainan {
 		j[id + "NoiseFrequency"] = ps.Customizer.m_NoiseCustomizer.m_NoiseFrequency;
 		j[id + "NoiseTarget"] = NoiseCustomizer::NoiseApplyTargetStr(ps.Customizer.m_NoiseCustomizer.NoiseTarget);
 		j[id + "NoiseInterpolationMode"] = NoiseCustomizer::NoiseInterpolationModeStr(ps.Customizer.m_NoiseCustomizer.NoiseInterpolationMode);
+		j[id + "NoiseUsePrecomputedField"] = ps.Customizer.m_NoiseCustomizer.m_UseNoiseField;
 
 		//Texture data
 		j[id + "UseDefaultTexture"] = ps.Customizer.m_TextureCustomizer.UseDefaultTexture;
@@ -171,6 +178,8 @@ namespace Ainan {
 				j[id + "Force" + std::to_string(i).c_str() + "DF_Value"] = VEC2_TO_JSON_ARRAY(force.second.DF_Value);
 				j[id + "Force" + std::to_string(i).c_str() + "RF_Target"] = VEC2_TO_JSON_ARRAY(force.second.RF_Target);
 				j[id + "Force" + std::to_string(i).c_str() + "RF_Strength"] = force.second.RF_Strength;
+				j[id + "Force" + std::to_string(i).c_str() + "NF_Radius"] = force.second.NF_Radius;
+				j[id + "Force" + std::to_string(i).c_str() + "NF_Strength"] = force.second.NF_Strength;
 
 				i++;
 			}
@@ -6,6 +6,8 @@
 
 namespace Ainan {
 
+	struct DrawKey;
+
 	enum EnvironmentObjectType 
 	{
 		ModelType,
@@ -38,6 +40,8 @@ namespace Ainan {
 		//this function does no graphics works (no OpenGL calls)
 		virtual void Update(const float deltaTime) {};
 		virtual void Draw() {};
+		//fills the state Draw uses so that draws can be sorted, returns false if Draw doesn't draw anything
+		virtual bool GetDrawKey(DrawKey& key) { return false; };
 		virtual void DisplayGuiControls() {};
 		virtual void OnTransform() {};
 		virtual std::shared_ptr<std::mutex> GetMutex() { return ObjectMutex; };
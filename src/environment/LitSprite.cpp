@@ -111,6 +111,14 @@ namespace Ainan {
 		Renderer::Draw(m_VertexBuffer, shader, Primitive::Triangles, 6);
 	}
 
+	bool LitSprite::GetDrawKey(DrawKey& key)
+	{
+		key.Blended = true;
+		key.Shader = Renderer::Rdata->ShaderLibrary["LitSpriteShader"].Identifier;
+		key.Depth = ModelMatrix[3].z;
+		return true;
+	}
+
 	int32_t LitSprite::GetAllowedGizmoOperation(ImGuizmo::OPERATION operation)
 	{
 		if (Space == OBJ_SPACE_2D)
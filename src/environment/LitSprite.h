@@ -13,6 +13,7 @@ namespace Ainan {
 
 		virtual void DisplayGuiControls() override;
 		virtual void Draw() override;
+		virtual bool GetDrawKey(DrawKey& key) override;
 		int32_t GetAllowedGizmoOperation(ImGuizmo::OPERATION operation) override;
 
 	public: //TODO make it private
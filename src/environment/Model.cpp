@@ -208,4 +208,16 @@ namespace Ainan {
 		}
 	}
 
+	bool Model::GetDrawKey(DrawKey& key)
+	{
+		if (m_Meshes.empty())
+			return false;
+
+		//the meshes bind their own textures, the first one is used to group models that share it
+		key.Shader = Renderer::ShaderLibrary()["3DAmbientShader"].Identifier;
+		key.Texture = m_Meshes[0].Textures[0].tex.Identifier;
+		key.Depth = ModelMatrix[3].z;
+		return true;
+	}
+
 }
\ No newline at end of file
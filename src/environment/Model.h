@@ -35,6 +35,7 @@ namespace Ainan {
 		void LoadModel(std::filesystem::path path);
 		void FreeModel();
 		void Draw() override;
+		bool GetDrawKey(DrawKey& key) override;
 		std::vector<Model::MeshTexture> LoadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
 
 	public:
@@ -0,0 +1,400 @@
+#include "ParticleKernels.h"
+
+namespace Ainan {
+namespace ParticleKernels {
+
+	//scalar versions, these are also used to finish the remaining particles that don't fill a whole SIMD register
+
+	static inline void ApplyRelativeForceOne(const ParticleArrays& p, size_t i, float targetX, float targetY, float strength)
+	{
+		float dx = targetX - p.PositionX[i];
+		float dy = targetY - p.PositionY[i];
+		float lengthSquared = dx * dx + dy * dy;
+
+		//a particle exactly on the target has no direction to move in
+		if (lengthSquared > 0.0f)
+		{
+			float scale = strength / std::sqrt(lengthSquared);
+			p.AccelerationX[i] += dx * scale;
+			p.AccelerationY[i] += dy * scale;
+		}
+	}
+
+	template<VelocityCustomizer::VelocityLimitType limitType>
+	static inline void IntegrateOne(const ParticleArrays& p, size_t i, const ParticleIntegrationParams& params)
+	{
+		float ax = p.AccelerationX[i] + params.ConstantAccelerationX;
+		float ay = p.AccelerationY[i] + params.ConstantAccelerationY;
+		float vx = p.VelocityX[i] + ax;
+		float vy = p.VelocityY[i] + ay;
+
+		p.PositionX[i] += vx * params.DeltaTime;
+		p.PositionY[i] += vy * params.DeltaTime;
+		p.RemainingLifeTime[i] -= params.DeltaTime;
+
+		if constexpr (limitType == VelocityCustomizer::NormalLimit)
+		{
+			float length = std::sqrt(vx * vx + vy * vy);
+			if ((length > params.MaxVelocityLength || length < params.MinVelocityLength) && length > 0.0f)
+			{
+				float scale = std::min(std::max(length, params.MinVelocityLength), params.MaxVelocityLength) / length;
+				vx *= scale;
+				vy *= scale;
+			}
+		}
+		else if constexpr (limitType == VelocityCustomizer::PerAxisLimit)
+		{
+			vx = std::min(std::max(vx, params.MinVelocityX), params.MaxVelocityX);
+			vy = std::min(std::max(vy, params.MinVelocityY), params.MaxVelocityY);
+		}
+
+		p.AccelerationX[i] = ax;
+		p.AccelerationY[i] = ay;
+		p.VelocityX[i] = vx;
+		p.VelocityY[i] = vy;
+	}
+
+	static void ApplyRelativeForceScalar(const ParticleArrays& p, size_t begin, size_t end, float targetX, float targetY, float strength)
+	{
+		for (size_t i = begin; i < end; i++)
+			ApplyRelativeForceOne(p, i, targetX, targetY, strength);
+	}
+
+	template<VelocityCustomizer::VelocityLimitType limitType>
+	static void IntegrateScalar(const ParticleArrays& p, size_t begin, size_t end, const ParticleIntegrationParams& params)
+	{
+		for (size_t i = begin; i < end; i++)
+			IntegrateOne<limitType>(p, i, params);
+	}
+
+#if AINAN_SIMD_X86
+
+	//SSE2 versions (4 particles at a time)
+
+	static void ApplyRelativeForceSSE(const ParticleArrays& p, size_t begin, size_t end, float targetX, float targetY, float strength)
+	{
+		const __m128 tx = _mm_set1_ps(targetX);
+		const __m128 ty = _mm_set1_ps(targetY);
+		const __m128 s = _mm_set1_ps(strength);
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t i = begin;
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(tx, _mm_loadu_ps(p.PositionX + i));
+			__m128 dy = _mm_sub_ps(ty, _mm_loadu_ps(p.PositionY + i));
+			__m128 lengthSquared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+			//lanes with a zero length get a scale of zero instead of a NaN
+			__m128 valid = _mm_cmpgt_ps(lengthSquared, zero);
+			__m128 scale = _mm_and_ps(valid, _mm_div_ps(s, _mm_sqrt_ps(lengthSquared)));
+
+			_mm_storeu_ps(p.AccelerationX + i, _mm_add_ps(_mm_loadu_ps(p.AccelerationX + i), _mm_mul_ps(dx, scale)));
+			_mm_storeu_ps(p.AccelerationY + i, _mm_add_ps(_mm_loadu_ps(p.AccelerationY + i), _mm_mul_ps(dy, scale)));
+		}
+
+		for (; i < end; i++)
+			ApplyRelativeForceOne(p, i, targetX, targetY, strength);
+	}
+
+	template<VelocityCustomizer::VelocityLimitType limitType>
+	static void IntegrateSSE(const ParticleArrays& p, size_t begin, size_t end, const ParticleIntegrationParams& params)
+	{
+		const __m128 dt = _mm_set1_ps(params.DeltaTime);
+		const __m128 constantAx = _mm_set1_ps(params.ConstantAccelerationX);
+		const __m128 constantAy = _mm_set1_ps(params.ConstantAccelerationY);
+		const __m128 minLength = _mm_set1_ps(params.MinVelocityLength);
+		const __m128 maxLength = _mm_set1_ps(params.MaxVelocityLength);
+		const __m128 minX = _mm_set1_ps(params.MinVelocityX);
+		const __m128 minY = _mm_set1_ps(params.MinVelocityY);
+		const __m128 maxX = _mm_set1_ps(params.MaxVelocityX);
+		const __m128 maxY = _mm_set1_ps(params.MaxVelocityY);
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t i = begin;
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 ax = _mm_add_ps(_mm_loadu_ps(p.AccelerationX + i), constantAx);
+			__m128 ay = _mm_add_ps(_mm_loadu_ps(p.AccelerationY + i), constantAy);
+			__m128 vx = _mm_add_ps(_mm_loadu_ps(p.VelocityX + i), ax);
+			__m128 vy = _mm_add_ps(_mm_loadu_ps(p.VelocityY + i), ay);
+
+			_mm_storeu_ps(p.PositionX + i, _mm_add_ps(_mm_loadu_ps(p.PositionX + i), _mm_mul_ps(vx, dt)));
+			_mm_storeu_ps(p.PositionY + i, _mm_add_ps(_mm_loadu_ps(p.PositionY + i), _mm_mul_ps(vy, dt)));
+			_mm_storeu_ps(p.RemainingLifeTime + i, _mm_sub_ps(_mm_loadu_ps(p.RemainingLifeTime + i), dt));
+
+			if constexpr (limitType == VelocityCustomizer::NormalLimit)
+			{
+				__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+				__m128 outside = _mm_or_ps(_mm_cmpgt_ps(length, maxLength), _mm_cmplt_ps(length, minLength));
+				__m128 mask = _mm_and_ps(outside, _mm_cmpgt_ps(length, zero));
+				__m128 scale = _mm_div_ps(_mm_min_ps(_mm_max_ps(length, minLength), maxLength), length);
+
+				//SSE2 has no blend, so select with and/andnot
+				vx = _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(vx, scale)), _mm_andnot_ps(mask, vx));
+				vy = _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(vy, scale)), _mm_andnot_ps(mask, vy));
+			}
+			else if constexpr (limitType == VelocityCustomizer::PerAxisLimit)
+			{
+				vx = _mm_min_ps(_mm_max_ps(vx, minX), maxX);
+				vy = _mm_min_ps(_mm_max_ps(vy, minY), maxY);
+			}
+
+			_mm_storeu_ps(p.AccelerationX + i, ax);
+			_mm_storeu_ps(p.AccelerationY + i, ay);
+			_mm_storeu_ps(p.VelocityX + i, vx);
+			_mm_storeu_ps(p.VelocityY + i, vy);
+		}
+
+		for (; i < end; i++)
+			IntegrateOne<limitType>(p, i, params);
+	}
+
+	//AVX2 versions (8 particles at a time)
+
+	AINAN_TARGET_AVX2
+	static void ApplyRelativeForceAVX2(const ParticleArrays& p, size_t begin, size_t end, float targetX, float targetY, float strength)
+	{
+		const __m256 tx = _mm256_set1_ps(targetX);
+		const __m256 ty = _mm256_set1_ps(targetY);
+		const __m256 s = _mm256_set1_ps(strength);
+		const __m256 zero = _mm256_setzero_ps();
+
+		size_t i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 dx = _mm256_sub_ps(tx, _mm256_loadu_ps(p.PositionX + i));
+			__m256 dy = _mm256_sub_ps(ty, _mm256_loadu_ps(p.PositionY + i));
+			__m256 lengthSquared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+			//lanes with a zero length get a scale of zero instead of a NaN
+			__m256 valid = _mm256_cmp_ps(lengthSquared, zero, _CMP_GT_OQ);
+			__m256 scale = _mm256_and_ps(valid, _mm256_div_ps(s, _mm256_sqrt_ps(lengthSquared)));
+
+			_mm256_storeu_ps(p.AccelerationX + i, _mm256_add_ps(_mm256_loadu_ps(p.AccelerationX + i), _mm256_mul_ps(dx, scale)));
+			_mm256_storeu_ps(p.AccelerationY + i, _mm256_add_ps(_mm256_loadu_ps(p.AccelerationY + i), _mm256_mul_ps(dy, scale)));
+		}
+
+		for (; i < end; i++)
+			ApplyRelativeForceOne(p, i, targetX, targetY, strength);
+	}
+
+	template<VelocityCustomizer::VelocityLimitType limitType>
+	AINAN_TARGET_AVX2
+	static void IntegrateAVX2(const ParticleArrays& p, size_t begin, size_t end, const ParticleIntegrationParams& params)
+	{
+		const __m256 dt = _mm256_set1_ps(params.DeltaTime);
+		const __m256 constantAx = _mm256_set1_ps(params.ConstantAccelerationX);
+		const __m256 constantAy = _mm256_set1_ps(params.ConstantAccelerationY);
+		const __m256 minLength = _mm256_set1_ps(params.MinVelocityLength);
+		const __m256 maxLength = _mm256_set1_ps(params.MaxVelocityLength);
+		const __m256 minX = _mm256_set1_ps(params.MinVelocityX);
+		const __m256 minY = _mm256_set1_ps(params.MinVelocityY);
+		const __m256 maxX = _mm256_set1_ps(params.MaxVelocityX);
+		const __m256 maxY = _mm256_set1_ps(params.MaxVelocityY);
+		const __m256 zero = _mm256_setzero_ps();
+
+		size_t i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 ax = _mm256_add_ps(_mm256_loadu_ps(p.AccelerationX + i), constantAx);
+			__m256 ay = _mm256_add_ps(_mm256_loadu_ps(p.AccelerationY + i), constantAy);
+			__m256 vx = _mm256_add_ps(_mm256_loadu_ps(p.VelocityX + i), ax);
+			__m256 vy = _mm256_add_ps(_mm256_loadu_ps(p.VelocityY + i), ay);
+
+			_mm256_storeu_ps(p.PositionX + i, _mm256_add_ps(_mm256_loadu_ps(p.PositionX + i), _mm256_mul_ps(vx, dt)));
+			_mm256_storeu_ps(p.PositionY + i, _mm256_add_ps(_mm256_loadu_ps(p.PositionY + i), _mm256_mul_ps(vy, dt)));
+			_mm256_storeu_ps(p.RemainingLifeTime + i, _mm256_sub_ps(_mm256_loadu_ps(p.RemainingLifeTime + i), dt));
+
+			if constexpr (limitType == VelocityCustomizer::NormalLimit)
+			{
+				__m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+				__m256 outside = _mm256_or_ps(_mm256_cmp_ps(length, maxLength, _CMP_GT_OQ), _mm256_cmp_ps(length, minLength, _CMP_LT_OQ));
+				__m256 mask = _mm256_and_ps(outside, _mm256_cmp_ps(length, zero, _CMP_GT_OQ));
+				__m256 scale = _mm256_div_ps(_mm256_min_ps(_mm256_max_ps(length, minLength), maxLength), length);
+
+				vx = _mm256_blendv_ps(vx, _mm256_mul_ps(vx, scale), mask);
+				vy = _mm256_blendv_ps(vy, _mm256_mul_ps(vy, scale), mask);
+			}
+			else if constexpr (limitType == VelocityCustomizer::PerAxisLimit)
+			{
+				vx = _mm256_min_ps(_mm256_max_ps(vx, minX), maxX);
+				vy = _mm256_min_ps(_mm256_max_ps(vy, minY), maxY);
+			}
+
+			_mm256_storeu_ps(p.AccelerationX + i, ax);
+			_mm256_storeu_ps(p.AccelerationY + i, ay);
+			_mm256_storeu_ps(p.VelocityX + i, vx);
+			_mm256_storeu_ps(p.VelocityY + i, vy);
+		}
+
+		for (; i < end; i++)
+			IntegrateOne<limitType>(p, i, params);
+	}
+
+#endif // AINAN_SIMD_X86
+
+	template<VelocityCustomizer::VelocityLimitType limitType>
+	static IntegrateKernel GetIntegrateKernelForLimit()
+	{
+#if AINAN_SIMD_X86
+		SIMDLevel level = GetSIMDLevel();
+		if (level >= SIMDLevel::AVX2)
+			return IntegrateAVX2<limitType>;
+		if (level >= SIMDLevel::SSE2)
+			return IntegrateSSE<limitType>;
+#endif
+		return IntegrateScalar<limitType>;
+	}
+
+	//neighbor forces are scalar only, the time goes into walking the grid and not into the math
+	template<Force::ForceType type>
+	static void ApplyNeighborForce(const ParticleArrays& p, const SpatialHashGrid& grid, size_t begin, size_t end, const NeighborForceParams& force)
+	{
+		float radiusSquared = force.Radius * force.Radius;
+		float inverseRadius = 1.0f / force.Radius;
+
+		for (size_t i = begin; i < end; i++)
+		{
+			float x = p.PositionX[i];
+			float y = p.PositionY[i];
+			float sumX = 0.0f;
+			float sumY = 0.0f;
+			uint32_t neighborCount = 0;
+
+			grid.ForEachNearby(x, y, [&](uint32_t j)
+				{
+					float dx = p.PositionX[j] - x;
+					float dy = p.PositionY[j] - y;
+					float distanceSquared = dx * dx + dy * dy;
+					if (j == i || distanceSquared >= radiusSquared)
+						return;
+
+					if constexpr (type == Force::SeparationForce)
+					{
+						//closer neighbors push harder, fading to nothing at the radius
+						if (distanceSquared > 0.0f)
+						{
+							float distance = std::sqrt(distanceSquared);
+							float weight = (1.0f - distance * inverseRadius) / distance;
+							sumX -= dx * weight;
+							sumY -= dy * weight;
+						}
+					}
+					else if constexpr (type == Force::CohesionForce)
+					{
+						sumX += dx;
+						sumY += dy;
+					}
+					else if constexpr (type == Force::AlignmentForce)
+					{
+						sumX += p.VelocityX[j];
+						sumY += p.VelocityY[j];
+					}
+					neighborCount++;
+				});
+
+			if (neighborCount == 0)
+				continue;
+
+			if constexpr (type == Force::SeparationForce)
+			{
+				p.AccelerationX[i] += sumX * force.Strength;
+				p.AccelerationY[i] += sumY * force.Strength;
+			}
+			else if constexpr (type == Force::CohesionForce)
+			{
+				//offset to the center of the neighbors, relative to the radius so that the strength doesn't depend on the scale
+				float scale = force.Strength * inverseRadius / neighborCount;
+				p.AccelerationX[i] += sumX * scale;
+				p.AccelerationY[i] += sumY * scale;
+			}
+			else if constexpr (type == Force::AlignmentForce)
+			{
+				p.AccelerationX[i] += (sumX / neighborCount - p.VelocityX[i]) * force.Strength;
+				p.AccelerationY[i] += (sumY / neighborCount - p.VelocityY[i]) * force.Strength;
+			}
+		}
+	}
+
+	void ApplyNeighborForces(const ParticleArrays& particles, const SpatialHashGrid& grid, size_t begin, size_t end,
+		const NeighborForceParams* forces, size_t forceCount)
+	{
+		for (size_t i = 0; i < forceCount; i++)
+		{
+			if (forces[i].Radius <= 0.0f)
+				continue;
+
+			switch (forces[i].Type)
+			{
+			case Force::SeparationForce:
+				ApplyNeighborForce<Force::SeparationForce>(particles, grid, begin, end, forces[i]);
+				break;
+
+			case Force::CohesionForce:
+				ApplyNeighborForce<Force::CohesionForce>(particles, grid, begin, end, forces[i]);
+				break;
+
+			case Force::AlignmentForce:
+				ApplyNeighborForce<Force::AlignmentForce>(particles, grid, begin, end, forces[i]);
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+
+	void ApplyRelativeForce(const ParticleArrays& particles, size_t begin, size_t end, float targetX, float targetY, float strength)
+	{
+#if AINAN_SIMD_X86
+		SIMDLevel level = GetSIMDLevel();
+		if (level >= SIMDLevel::AVX2)
+			return ApplyRelativeForceAVX2(particles, begin, end, targetX, targetY, strength);
+		if (level >= SIMDLevel::SSE2)
+			return ApplyRelativeForceSSE(particles, begin, end, targetX, targetY, strength);
+#endif
+		ApplyRelativeForceScalar(particles, begin, end, targetX, targetY, strength);
+	}
+
+	void Integrate(const ParticleArrays& particles, size_t begin, size_t end, const ParticleIntegrationParams& params)
+	{
+		GetIntegrateKernel(params.LimitType)(particles, begin, end, params);
+	}
+
+	IntegrateKernel GetIntegrateKernel(VelocityCustomizer::VelocityLimitType limitType)
+	{
+		//the limit mode is resolved here once, so the per particle loops have no branches on it
+		switch (limitType)
+		{
+		case VelocityCustomizer::NormalLimit:
+			return GetIntegrateKernelForLimit<VelocityCustomizer::NormalLimit>();
+
+		case VelocityCustomizer::PerAxisLimit:
+			return GetIntegrateKernelForLimit<VelocityCustomizer::PerAxisLimit>();
+
+		case VelocityCustomizer::NoLimit:
+		default:
+			return GetIntegrateKernelForLimit<VelocityCustomizer::NoLimit>();
+		}
+	}
+
+	void FillDrawBuffers(const ParticleDrawArrays& p, size_t begin, size_t end, const ParticleDrawParams& params)
+	{
+		glm::vec4 colorDifference = params.EndColor - params.StartColor;
+
+		for (size_t i = begin; i < end; i++)
+		{
+			//get a value from 0 to 1, showing how much the particle lived.
+			//1 meaning it's lifetime is over and it is going to die (get deactivated and not rendered).
+			//0 meaning it's just been spawned (activated).
+			float t = (p.LifeTime[i] - p.RemainingLifeTime[i]) / p.LifeTime[i];
+
+			p.Translation[i].x = p.PreviousPositionX[i] + (p.PositionX[i] - p.PreviousPositionX[i]) * params.InterpolationFactor;
+			p.Translation[i].y = p.PreviousPositionY[i] + (p.PositionY[i] - p.PreviousPositionY[i]) * params.InterpolationFactor;
+			p.Scale[i] = p.StartScale[i] + (p.EndScale[i] - p.StartScale[i]) * params.ScaleCurve->Sample(t);
+			p.Color[i] = params.StartColor + colorDifference * params.ColorCurve->Sample(t);
+		}
+	}
+}
+}
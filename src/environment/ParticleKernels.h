@@ -0,0 +1,109 @@
+#pragma once
+
+#include "math/SIMD.h"
+#include "editor/customizers/VelocityCustomizer.h"
+#include "editor/customizers/ForceCustomizer.h"
+#include "math/CurveLUT.h"
+#include "SpatialHashGrid.h"
+
+namespace Ainan {
+
+	//structure of arrays view over the particle pool.
+	//all the kernels work on the index range [begin, end) of these arrays
+	struct ParticleArrays
+	{
+		float* PositionX = nullptr;
+		float* PositionY = nullptr;
+		float* VelocityX = nullptr;
+		float* VelocityY = nullptr;
+		float* AccelerationX = nullptr;
+		float* AccelerationY = nullptr;
+		float* RemainingLifeTime = nullptr;
+		//set once when the particle spawns, so the noise of a particle doesn't change when it moves to another index
+		float* NoiseOffset = nullptr;
+	};
+
+	//everything the integration kernel needs, gathered once per frame from the customizers
+	struct ParticleIntegrationParams
+	{
+		float DeltaTime = 0.0f;
+
+		//sum of all the enabled directional forces, already multiplied by the delta time
+		float ConstantAccelerationX = 0.0f;
+		float ConstantAccelerationY = 0.0f;
+
+		VelocityCustomizer::VelocityLimitType LimitType = VelocityCustomizer::NoLimit;
+		float MinVelocityLength = 0.0f; //ONLY USED IN NormalLimit MODE
+		float MaxVelocityLength = 0.0f; //ONLY USED IN NormalLimit MODE
+		float MinVelocityX = 0.0f;      //ONLY USED IN PerAxisLimit MODE
+		float MinVelocityY = 0.0f;      //ONLY USED IN PerAxisLimit MODE
+		float MaxVelocityX = 0.0f;      //ONLY USED IN PerAxisLimit MODE
+		float MaxVelocityY = 0.0f;      //ONLY USED IN PerAxisLimit MODE
+	};
+
+	//a force that depends on the particles around each particle (see Force::IsNeighborForce)
+	struct NeighborForceParams
+	{
+		Force::ForceType Type = Force::SeparationForce;
+		float Radius = 0.0f;   //only particles closer than this are affected
+		float Strength = 0.0f; //already multiplied by the delta time
+	};
+
+	//input and output of the draw kernels, the outputs are the draw buffers passed to the renderer
+	struct ParticleDrawArrays
+	{
+		const float* PositionX = nullptr;
+		const float* PositionY = nullptr;
+		const float* PreviousPositionX = nullptr;
+		const float* PreviousPositionY = nullptr;
+		const float* StartScale = nullptr;
+		const float* EndScale = nullptr;
+		const float* LifeTime = nullptr;
+		const float* RemainingLifeTime = nullptr;
+
+		glm::vec2* Translation = nullptr;
+		float* Scale = nullptr;
+		glm::vec4* Color = nullptr;
+	};
+
+	struct ParticleDrawParams
+	{
+		glm::vec4 StartColor = glm::vec4(1.0f);
+		glm::vec4 EndColor = glm::vec4(1.0f);
+		//weight (from 0 to 1) of the end value over the lifetime of a particle
+		const CurveLUT* ScaleCurve = nullptr;
+		const CurveLUT* ColorCurve = nullptr;
+
+		//particles are drawn at lerp(previous position, position, InterpolationFactor)
+		float InterpolationFactor = 1.0f;
+	};
+
+	//these pick an SSE/AVX2 implementation if the CPU supports it and fall back to scalar code otherwise.
+	//every implementation gives the same results so they can be mixed freely
+	namespace ParticleKernels {
+
+		//acceleration += normalize(target - position) * strength
+		//NOTE: strength should already be multiplied by the delta time
+		void ApplyRelativeForce(const ParticleArrays& particles, size_t begin, size_t end, float targetX, float targetY, float strength);
+
+		//adds the neighbor forces to the acceleration of the particles in [begin, end).
+		//the grid must be built from the current positions with a cell size of at least the largest radius.
+		//this reads the position and velocity of every particle but only writes acceleration in [begin, end),
+		//so it can run in parallel with itself as long as nothing else writes positions or velocities at the same time
+		void ApplyNeighborForces(const ParticleArrays& particles, const SpatialHashGrid& grid, size_t begin, size_t end,
+			const NeighborForceParams* forces, size_t forceCount);
+
+		//adds the constant acceleration, integrates velocity and position, decrements the remaining lifetime and limits the velocity.
+		//dead particles (remaining lifetime < 0) are NOT removed here, that is left to the caller
+		void Integrate(const ParticleArrays& particles, size_t begin, size_t end, const ParticleIntegrationParams& params);
+
+		//an Integrate specialized for one limit mode and the SIMD level of this CPU, params.LimitType is ignored by it.
+		//get it once per frame and call it for every chunk to skip the dispatch
+		using IntegrateKernel = void(*)(const ParticleArrays& particles, size_t begin, size_t end, const ParticleIntegrationParams& params);
+		IntegrateKernel GetIntegrateKernel(VelocityCustomizer::VelocityLimitType limitType);
+
+		//fills the draw buffers of the particles in [begin, end) with their position, scale and color at their current age.
+		//the interpolation curves are read from the baked tables, so every interpolation type costs the same
+		void FillDrawBuffers(const ParticleDrawArrays& particles, size_t begin, size_t end, const ParticleDrawParams& params);
+	}
+}
@@ -1,5 +1,7 @@
 #include "ParticleSystem.h"
 
+#include "ThreadPool.h"
+
 namespace Ainan {
 	static Texture DefaultTexture;
 	static int s_DefaultTextureUserCount = 0;
@@ -11,19 +13,8 @@ namespace Ainan {
 
 		m_Name = "Particle System";
 
-		m_ParticleDrawTranslationBuffer.resize(c_ParticlePoolSize);
-		m_ParticleDrawScaleBuffer.resize(c_ParticlePoolSize);
-		m_ParticleDrawColorBuffer.resize(c_ParticlePoolSize);
-
 		//initilize data for the particles
-		m_Particles.IsActive.resize(c_ParticlePoolSize);
-		m_Particles.Position.resize(c_ParticlePoolSize);
-		m_Particles.Velocity.resize(c_ParticlePoolSize);
-		m_Particles.Acceleration.resize(c_ParticlePoolSize);
-		m_Particles.StartScale.resize(c_ParticlePoolSize);
-		m_Particles.EndScale.resize(c_ParticlePoolSize);
-		m_Particles.LifeTime.resize(c_ParticlePoolSize);
-		m_Particles.RemainingLifeTime.resize(c_ParticlePoolSize);
+		ReserveParticlePool(c_InitialParticlePoolSize);
 
 		//initilize the default shader
 		s_DefaultTextureUserCount++;
@@ -43,119 +34,222 @@ namespace Ainan {
 
 	void ParticleSystem::Update(const float deltaTime)
 	{
-		SpawnAllParticlesOnQue(deltaTime);
+		if (!Customizer.m_UseFixedTimeStep)
+		{
+			StepSimulation(deltaTime);
+			m_InterpolationFactor = 1.0f;
+			m_PreviousPositionsValid = false;
+			return;
+		}
 
-		ActiveParticleCount = 0;
-		for (size_t i = 0; i < c_ParticlePoolSize; i++) {
+		//the previous positions are only kept while using a fixed time step, so they are outdated if it was just turned on
+		if (!m_PreviousPositionsValid)
+		{
+			std::copy(m_Particles.PositionX.begin(), m_Particles.PositionX.begin() + ActiveParticleCount, m_Particles.PreviousPositionX.begin());
+			std::copy(m_Particles.PositionY.begin(), m_Particles.PositionY.begin() + ActiveParticleCount, m_Particles.PreviousPositionY.begin());
+			m_PreviousPositionsValid = true;
+		}
 
-			if(m_Particles.IsActive[i]) 
-			{
-				//do noise calculations
-				Customizer.m_NoiseCustomizer.ApplyNoise(m_Particles.Position[i],
-					m_Particles.Velocity[i],
-					m_Particles.Acceleration[i],
-					i);
-
-				//add forces to the particle
-				for (auto& force : Customizer.m_ForceCustomizer.m_Forces)
-				{
-					if (force.second.Enabled) 
-						m_Particles.Acceleration[i] += force.second.GetEffect(m_Particles.Position[i]) * deltaTime;
-				}
+		//the simulation always moves forward in steps of the same size, no matter how long the frame took.
+		//time that doesn't fill a whole step is kept for the next frame
+		float stepTime = 1.0f / Customizer.m_FixedStepsPerSecond;
+		m_TimeAccumulator += deltaTime;
 
-				//update particle speed, lifetime etc
-				m_Particles.Velocity[i] += m_Particles.Acceleration[i];
-				m_Particles.Position[i] += m_Particles.Velocity[i] * deltaTime;
+		int32_t stepCount = 0;
+		while (m_TimeAccumulator >= stepTime && stepCount < Customizer.m_MaxStepsPerFrame)
+		{
+			StepSimulation(stepTime);
+			m_TimeAccumulator -= stepTime;
+			stepCount++;
+		}
 
-				m_Particles.RemainingLifeTime[i] -= deltaTime;
-				if (m_Particles.RemainingLifeTime[i] < 0.0f)
-					m_Particles.IsActive[i] = false;
+		//if we can't keep up, drop the time we are behind instead of trying to catch up with even more steps next frame
+		if (stepCount == Customizer.m_MaxStepsPerFrame)
+			m_TimeAccumulator = std::min(m_TimeAccumulator, stepTime);
 
+		//how far we are between the last two steps, used to draw the particles between their last two positions
+		m_InterpolationFactor = std::clamp(m_TimeAccumulator / stepTime, 0.0f, 1.0f);
+	}
 
-				//limit particle velocity
-				if (Customizer.m_VelocityCustomizer.CurrentVelocityLimitType != VelocityCustomizer::NoLimit)
-				{
-					//to make the code look cleaner
-					VelocityCustomizer& velocityCustomizer = Customizer.m_VelocityCustomizer;
+	void ParticleSystem::StepSimulation(float deltaTime)
+	{
+		//drop particles if the limit was lowered since the last frame
+		if (ActiveParticleCount > (uint32_t)Customizer.m_MaxParticleCount)
+			ActiveParticleCount = Customizer.m_MaxParticleCount;
 
-					//use normal velocity limit
-					//by calculating the velocity in both x and y and limiting the length of the vector
-					if (velocityCustomizer.CurrentVelocityLimitType == VelocityCustomizer::NormalLimit)
-					{
-						float length = glm::length(m_Particles.Velocity[i]);
-						if (length > velocityCustomizer.m_MaxNormalVelocityLimit ||
-							length < velocityCustomizer.m_MinNormalVelocityLimit)
-						{
-							glm::vec2 direction = glm::normalize(m_Particles.Velocity[i]);
-							length = std::clamp(length, velocityCustomizer.m_MinNormalVelocityLimit, velocityCustomizer.m_MaxNormalVelocityLimit);
-							m_Particles.Velocity[i] = length * direction;
-						}
-					}
-					//limit velocity in each axis
-					else if (Customizer.m_VelocityCustomizer.CurrentVelocityLimitType == VelocityCustomizer::PerAxisLimit)
-					{
-						m_Particles.Velocity[i].x = std::clamp(m_Particles.Velocity[i].x, velocityCustomizer.m_MinPerAxisVelocityLimit.x, velocityCustomizer.m_MaxPerAxisVelocityLimit.x);
-						m_Particles.Velocity[i].y = std::clamp(m_Particles.Velocity[i].y, velocityCustomizer.m_MinPerAxisVelocityLimit.y, velocityCustomizer.m_MaxPerAxisVelocityLimit.y);
-					}
-				}
+		SpawnAllParticlesOnQue(deltaTime);
+		SpawnBatch(QueuedBurstParticles.exchange(0));
 
-				//update active particle count
-				ActiveParticleCount++;
-			}
+		ParticleArrays particles = GetParticleArrays();
+		size_t count = ActiveParticleCount;
+
+		Customizer.m_NoiseCustomizer.PrepareNoise();
+		CompileUpdateKernels(deltaTime);
+
+		//neighbor forces read other particles, so they run as a separate pass over positions and velocities
+		//from the start of the frame, before anything below moves them
+		if (m_NeighborForces.size() > 0 && m_MaxNeighborRadius > 0.0f)
+		{
+			m_NeighborGrid.Build(particles.PositionX, particles.PositionY, count, m_MaxNeighborRadius);
+
+			ThreadPool::ParallelFor(count, c_ParticleUpdateChunkSize, [&](size_t begin, size_t end)
+				{
+					ParticleKernels::ApplyNeighborForces(particles, m_NeighborGrid, begin, end, m_NeighborForces.data(), m_NeighborForces.size());
+				});
+		}
+
+		//from here on particles don't depend on each other, so every chunk runs the whole pipeline on its own range.
+		//each particle goes through the exact same steps as in a serial loop, so the result doesn't depend on the thread count
+		ThreadPool::ParallelFor(count, c_ParticleUpdateChunkSize, [&](size_t begin, size_t end)
+			{
+				for (auto& kernel : m_UpdateKernels)
+					kernel(particles, begin, end);
+			});
+
+		//remove dead particles
+		//NOTE: i is only advanced when the particle survives, because killing a particle moves
+		//the last alive particle into index i
+		size_t i = 0;
+		while (i < ActiveParticleCount)
+		{
+			if (m_Particles.RemainingLifeTime[i] < 0.0f)
+				KillParticle(i);
+			else
+				i++;
 		}
 	}
 
-	void ParticleSystem::Draw()
+	void ParticleSystem::CompileUpdateKernels(float deltaTime)
 	{
-		//reset the amount of particles to be drawn every frame
-		m_ParticleDrawCount = 0;
+		m_UpdateKernels.clear();
+		m_NeighborForces.clear();
+		m_MaxNeighborRadius = 0.0f;
 
-		//go through all the particles
-		for (size_t i = 0; i < c_ParticlePoolSize; i++)
+		//keep the positions from before this step to draw the particles between the last two steps
+		if (Customizer.m_UseFixedTimeStep)
 		{
-			if (m_Particles.IsActive[i]) 
-			{
+			float* previousPositionX = m_Particles.PreviousPositionX.data();
+			float* previousPositionY = m_Particles.PreviousPositionY.data();
+			m_UpdateKernels.push_back([previousPositionX, previousPositionY](const ParticleArrays& particles, size_t begin, size_t end)
+				{
+					std::memcpy(previousPositionX + begin, particles.PositionX + begin, (end - begin) * sizeof(float));
+					std::memcpy(previousPositionY + begin, particles.PositionY + begin, (end - begin) * sizeof(float));
+				});
+		}
 
-				//get a value from 0 to 1, showing how much the particle lived.
-				//1 meaning it's lifetime is over and it is going to die (get deactivated and not rendered).
-				//0 meaning it's just been spawned (activated).
-				float t = (m_Particles.LifeTime[i] - m_Particles.RemainingLifeTime[i]) / m_Particles.LifeTime[i];
+		ParticleIntegrationParams params;
+		params.DeltaTime = deltaTime;
 
-				//use the t value to get the scale of the particle using it's not using a Custom Curve
-				float scale = 0.0f;
-				if (Customizer.m_ScaleCustomizer.m_InterpolationType != Custom)
+		//do noise calculations
+		if (Customizer.m_NoiseCustomizer.IsEnabled())
+		{
+			NoiseCustomizer* noise = &Customizer.m_NoiseCustomizer;
+			m_UpdateKernels.push_back([noise](const ParticleArrays& particles, size_t begin, size_t end)
 				{
-					scale = 
-						Interpolation::Interporpolate(Customizer.m_ScaleCustomizer.m_InterpolationType,
-						m_Particles.StartScale[i],
-						m_Particles.EndScale[i],
-						t);
-				}
-				else
-					scale = Customizer.m_ScaleCustomizer.m_Curve.Interpolate(m_Particles.StartScale[i], m_Particles.EndScale[i], t);
-
-				//put the drawing properties of the particles in the draw buffers that would be drawn this frame
-				m_ParticleDrawTranslationBuffer[m_ParticleDrawCount] = m_Particles.Position[i];
-				m_ParticleDrawScaleBuffer[m_ParticleDrawCount] = scale;
-
-				m_ParticleDrawColorBuffer[m_ParticleDrawCount] =
-					Interpolation::Interporpolate(Customizer.m_ColorCustomizer.m_InterpolationType,
-						Customizer.m_ColorCustomizer.StartColor,
-						Customizer.m_ColorCustomizer.EndColor,
-						t);
-
-				//up the amount of particles to be drawn this frame
-				m_ParticleDrawCount++;
+					noise->ApplyNoise(particles, begin, end);
+				});
+		}
+
+		//add forces to the particles.
+		//directional forces are the same for every particle so they are summed once here and added while integrating
+		for (auto& force : Customizer.m_ForceCustomizer.m_Forces)
+		{
+			if (!force.second.Enabled)
+				continue;
+
+			if (force.second.Type == Force::DirectionalForce)
+			{
+				params.ConstantAccelerationX += force.second.DF_Value.x * deltaTime;
+				params.ConstantAccelerationY += force.second.DF_Value.y * deltaTime;
+			}
+			else if (Force::IsNeighborForce(force.second.Type))
+			{
+				NeighborForceParams neighborForce;
+				neighborForce.Type = force.second.Type;
+				neighborForce.Radius = force.second.NF_Radius;
+				neighborForce.Strength = force.second.NF_Strength * deltaTime;
+				m_NeighborForces.push_back(neighborForce);
+				m_MaxNeighborRadius = std::max(m_MaxNeighborRadius, force.second.NF_Radius);
+			}
+			else
+			{
+				float targetX = force.second.RF_Target.x;
+				float targetY = force.second.RF_Target.y;
+				float strength = force.second.RF_Strength * deltaTime;
+				m_UpdateKernels.push_back([targetX, targetY, strength](const ParticleArrays& particles, size_t begin, size_t end)
+					{
+						ParticleKernels::ApplyRelativeForce(particles, begin, end, targetX, targetY, strength);
+					});
 			}
 		}
 
+		//velocity limit data
+		VelocityCustomizer& velocityCustomizer = Customizer.m_VelocityCustomizer;
+		params.LimitType = velocityCustomizer.CurrentVelocityLimitType;
+		params.MinVelocityLength = velocityCustomizer.m_MinNormalVelocityLimit;
+		params.MaxVelocityLength = velocityCustomizer.m_MaxNormalVelocityLimit;
+		params.MinVelocityX = velocityCustomizer.m_MinPerAxisVelocityLimit.x;
+		params.MinVelocityY = velocityCustomizer.m_MinPerAxisVelocityLimit.y;
+		params.MaxVelocityX = velocityCustomizer.m_MaxPerAxisVelocityLimit.x;
+		params.MaxVelocityY = velocityCustomizer.m_MaxPerAxisVelocityLimit.y;
+
+		//update particle speed, position, lifetime etc
+		ParticleKernels::IntegrateKernel integrate = ParticleKernels::GetIntegrateKernel(params.LimitType);
+		m_UpdateKernels.push_back([integrate, params](const ParticleArrays& particles, size_t begin, size_t end)
+			{
+				integrate(particles, begin, end, params);
+			});
+	}
+
+	void ParticleSystem::Draw()
+	{
+		//alive particles are packed at the start of the pool, so all of them are drawn
+		m_ParticleDrawCount = ActiveParticleCount;
+
+		ParticleDrawArrays drawArrays;
+		drawArrays.PositionX = m_Particles.PositionX.data();
+		drawArrays.PositionY = m_Particles.PositionY.data();
+		//without a fixed time step the particles are drawn at their current position
+		drawArrays.PreviousPositionX = Customizer.m_UseFixedTimeStep ? m_Particles.PreviousPositionX.data() : m_Particles.PositionX.data();
+		drawArrays.PreviousPositionY = Customizer.m_UseFixedTimeStep ? m_Particles.PreviousPositionY.data() : m_Particles.PositionY.data();
+		drawArrays.StartScale = m_Particles.StartScale.data();
+		drawArrays.EndScale = m_Particles.EndScale.data();
+		drawArrays.LifeTime = m_Particles.LifeTime.data();
+		drawArrays.RemainingLifeTime = m_Particles.RemainingLifeTime.data();
+		drawArrays.Translation = m_ParticleDrawTranslationBuffer.data();
+		drawArrays.Scale = m_ParticleDrawScaleBuffer.data();
+		drawArrays.Color = m_ParticleDrawColorBuffer.data();
+
+		ParticleDrawParams drawParams;
+		drawParams.StartColor = Customizer.m_ColorCustomizer.StartColor;
+		drawParams.EndColor = Customizer.m_ColorCustomizer.EndColor;
+		drawParams.ScaleCurve = &Customizer.m_ScaleCustomizer.GetCurveLUT();
+		drawParams.ColorCurve = &Customizer.m_ColorCustomizer.GetCurveLUT();
+		drawParams.InterpolationFactor = Customizer.m_UseFixedTimeStep ? m_InterpolationFactor : 1.0f;
+
+		ThreadPool::ParallelFor(m_ParticleDrawCount, c_ParticleUpdateChunkSize, [&](size_t begin, size_t end)
+			{
+				ParticleKernels::FillDrawBuffers(drawArrays, begin, end, drawParams);
+			});
+
 		if(Customizer.m_TextureCustomizer.UseDefaultTexture)
 			Renderer::DrawQuadv(m_ParticleDrawTranslationBuffer.data(), m_ParticleDrawColorBuffer.data(),
 				m_ParticleDrawScaleBuffer.data(), m_ParticleDrawCount, DefaultTexture);
 		else
 			Renderer::DrawQuadv(m_ParticleDrawTranslationBuffer.data(), m_ParticleDrawColorBuffer.data(),
-				m_ParticleDrawScaleBuffer.data(), m_ParticleDrawCount, Customizer.m_TextureCustomizer.ParticleTexture);
+				m_ParticleDrawScaleBuffer.data(), m_ParticleDrawCount, Customizer.m_TextureCustomizer.ParticleTextureRegion);
+
+	}
 
+	bool ParticleSystem::GetDrawKey(DrawKey& key)
+	{
+		key.Blended = true;
+		key.Shader = Renderer::Rdata->ShaderLibrary["QuadInstanceShader"].Identifier;
+		if (Customizer.m_TextureCustomizer.UseDefaultTexture)
+			key.Texture = DefaultTexture.Identifier;
+		else
+			key.Texture = Customizer.m_TextureCustomizer.ParticleTextureRegion.Page.Identifier;
+		return true;
 	}
 
 	void ParticleSystem::OnTransform()
@@ -163,36 +257,115 @@ namespace Ainan {
 		Customizer.m_SpawnPosition = ModelMatrix[3];
 	}
 
-	void ParticleSystem::SpawnParticle(const ParticleDescription& particle)
+	void ParticleSystem::SpawnBatch(size_t count)
+	{
+		size_t maxCount = (size_t)Customizer.m_MaxParticleCount;
+		if (ActiveParticleCount >= maxCount)
+			return;
+
+		count = std::min(count, maxCount - ActiveParticleCount);
+		if (count == 0)
+			return;
+
+		ReserveParticlePool(ActiveParticleCount + count);
+
+		//the new particles go right after the alive ones
+		size_t first = ActiveParticleCount;
+		ParticleSpawnArrays particles;
+		particles.PositionX = m_Particles.PositionX.data() + first;
+		particles.PositionY = m_Particles.PositionY.data() + first;
+		particles.VelocityX = m_Particles.VelocityX.data() + first;
+		particles.VelocityY = m_Particles.VelocityY.data() + first;
+		particles.AccelerationX = m_Particles.AccelerationX.data() + first;
+		particles.AccelerationY = m_Particles.AccelerationY.data() + first;
+		particles.StartScale = m_Particles.StartScale.data() + first;
+		particles.EndScale = m_Particles.EndScale.data() + first;
+		particles.LifeTime = m_Particles.LifeTime.data() + first;
+		particles.RemainingLifeTime = m_Particles.RemainingLifeTime.data() + first;
+		particles.NoiseOffset = m_Particles.NoiseOffset.data() + first;
+
+		Customizer.GenerateParticles(particles, count);
+
+		ActiveParticleCount += (uint32_t)count;
+	}
+
+	void ParticleSystem::KillParticle(size_t index)
 	{
-		//go through all the particles
-		for (size_t i = 0; i < c_ParticlePoolSize; i++)
+		size_t last = ActiveParticleCount - 1;
+
+		if (index != last)
 		{
-			//find a particle that is not active
-			if (!m_Particles.IsActive[i])
-			{
-				//assign particle variables from the passed particle
-				m_Particles.Position[i] = particle.Position;
-				m_Particles.Velocity[i] = particle.Velocity;
-				m_Particles.IsActive[i] = true;
-				m_Particles.StartScale[i] = particle.StartScale;
-				m_Particles.EndScale[i] = particle.EndScale;
-				m_Particles.LifeTime[i] = particle.LifeTime;
-				m_Particles.RemainingLifeTime[i] = particle.LifeTime;
-				m_Particles.Acceleration[i] = particle.Acceleration;
-
-				//break out of the for loop because we are spawning one particle only
-				break;
-			}
+			m_Particles.PositionX[index] = m_Particles.PositionX[last];
+			m_Particles.PositionY[index] = m_Particles.PositionY[last];
+			m_Particles.PreviousPositionX[index] = m_Particles.PreviousPositionX[last];
+			m_Particles.PreviousPositionY[index] = m_Particles.PreviousPositionY[last];
+			m_Particles.VelocityX[index] = m_Particles.VelocityX[last];
+			m_Particles.VelocityY[index] = m_Particles.VelocityY[last];
+			m_Particles.AccelerationX[index] = m_Particles.AccelerationX[last];
+			m_Particles.AccelerationY[index] = m_Particles.AccelerationY[last];
+			m_Particles.StartScale[index] = m_Particles.StartScale[last];
+			m_Particles.EndScale[index] = m_Particles.EndScale[last];
+			m_Particles.LifeTime[index] = m_Particles.LifeTime[last];
+			m_Particles.RemainingLifeTime[index] = m_Particles.RemainingLifeTime[last];
+			m_Particles.NoiseOffset[index] = m_Particles.NoiseOffset[last];
 		}
 
-		//if no inactive particle is found, don't do anything (do not spawn a new particle)
+		ActiveParticleCount--;
+	}
+
+	void ParticleSystem::ReserveParticlePool(size_t count)
+	{
+		if (count <= m_ParticlePoolSize)
+			return;
+
+		//grow geometrically so that spawning is amortized O(1), but never past the particle limit
+		size_t newSize = std::max(count, m_ParticlePoolSize * 2);
+		newSize = std::min(newSize, std::max(count, (size_t)Customizer.m_MaxParticleCount));
+
+		m_Particles.PositionX.resize(newSize);
+		m_Particles.PositionY.resize(newSize);
+		m_Particles.PreviousPositionX.resize(newSize);
+		m_Particles.PreviousPositionY.resize(newSize);
+		m_Particles.VelocityX.resize(newSize);
+		m_Particles.VelocityY.resize(newSize);
+		m_Particles.AccelerationX.resize(newSize);
+		m_Particles.AccelerationY.resize(newSize);
+		m_Particles.StartScale.resize(newSize);
+		m_Particles.EndScale.resize(newSize);
+		m_Particles.LifeTime.resize(newSize);
+		m_Particles.RemainingLifeTime.resize(newSize);
+		m_Particles.NoiseOffset.resize(newSize);
+
+		m_ParticleDrawTranslationBuffer.resize(newSize);
+		m_ParticleDrawScaleBuffer.resize(newSize);
+		m_ParticleDrawColorBuffer.resize(newSize);
+
+		m_ParticlePoolSize = newSize;
+	}
+
+	ParticleArrays ParticleSystem::GetParticleArrays()
+	{
+		ParticleArrays arrays;
+		arrays.PositionX = m_Particles.PositionX.data();
+		arrays.PositionY = m_Particles.PositionY.data();
+		arrays.VelocityX = m_Particles.VelocityX.data();
+		arrays.VelocityY = m_Particles.VelocityY.data();
+		arrays.AccelerationX = m_Particles.AccelerationX.data();
+		arrays.AccelerationY = m_Particles.AccelerationY.data();
+		arrays.RemainingLifeTime = m_Particles.RemainingLifeTime.data();
+		arrays.NoiseOffset = m_Particles.NoiseOffset.data();
+		return arrays;
 	}
 
 	void ParticleSystem::ClearParticles()
 	{
-		//deactivate all particles which will make them stop rendering
-		m_Particles.IsActive.assign(m_Particles.IsActive.size(), false);
+		//alive particles are the ones before ActiveParticleCount, so this kills all of them
+		ActiveParticleCount = 0;
+
+		//start over exactly like a new system, so running the simulation again gives the same particles
+		TimeTillNextParticleSpawn = 0.0f;
+		m_TimeAccumulator = 0.0f;
+		Customizer.ResetRandomStream();
 	}
 
 	ParticleSystem::ParticleSystem(const ParticleSystem& Psystem) :
@@ -205,6 +378,8 @@ namespace Ainan {
 
 		//copy other variables
 		m_Particles = Psystem.m_Particles;
+		m_ParticlePoolSize = Psystem.m_ParticlePoolSize;
+		ActiveParticleCount = Psystem.ActiveParticleCount;
 		m_Name = Psystem.m_Name;
 		RenameTextOpen = Psystem.RenameTextOpen;
 	}
@@ -241,6 +416,56 @@ namespace Ainan {
 			//limit to 1000
 			Customizer.m_ParticlesPerSecond = std::clamp(Customizer.m_ParticlesPerSecond, 0.1f, 1000.0f);
 
+			ImGui::NextColumn();
+			ImGui::Text("Max Particles: ");
+			ImGui::NextColumn();
+			ImGui::DragInt("##Max Particles: ", &Customizer.m_MaxParticleCount, 100.0f, 1, c_MaxParticleCountLimit);
+
+			Customizer.m_MaxParticleCount = std::clamp(Customizer.m_MaxParticleCount, 1, c_MaxParticleCountLimit);
+
+			ImGui::NextColumn();
+			ImGui::Text("Seed: ");
+			ImGui::NextColumn();
+			if (ImGui::InputScalar("##Seed: ", ImGuiDataType_U32, &Customizer.m_Seed))
+				Customizer.ResetRandomStream();
+
+			ImGui::NextColumn();
+			ImGui::Text("Burst Size: ");
+			ImGui::NextColumn();
+			ImGui::DragInt("##Burst Size: ", &Customizer.m_BurstCount, 10.0f, 1, c_MaxParticleCountLimit);
+			Customizer.m_BurstCount = std::clamp(Customizer.m_BurstCount, 1, c_MaxParticleCountLimit);
+
+			ImGui::NextColumn();
+			ImGui::NextColumn();
+			if (ImGui::Button("Spawn Burst"))
+				QueuedBurstParticles += Customizer.m_BurstCount;
+
+			ImGui::NextColumn();
+			ImGui::TreePop();
+		}
+
+		ImGui::SeparatorEx(ImGuiSeparatorFlags_Horizontal | ImGuiSeparatorFlags_SpanAllColumns);
+		if (ImGui::TreeNode("Simulation"))
+		{
+			ImGui::Text("Fixed Time Step: ");
+			ImGui::NextColumn();
+			ImGui::Checkbox("##Fixed Time Step: ", &Customizer.m_UseFixedTimeStep);
+
+			if (Customizer.m_UseFixedTimeStep)
+			{
+				ImGui::NextColumn();
+				ImGui::Text("Steps Per Second: ");
+				ImGui::NextColumn();
+				ImGui::DragInt("##Steps Per Second: ", &Customizer.m_FixedStepsPerSecond, 1.0f, 1, c_MaxFixedStepsPerSecond);
+				Customizer.m_FixedStepsPerSecond = std::clamp(Customizer.m_FixedStepsPerSecond, 1, c_MaxFixedStepsPerSecond);
+
+				ImGui::NextColumn();
+				ImGui::Text("Max Steps\nPer Frame: ");
+				ImGui::NextColumn();
+				ImGui::DragInt("##Max Steps Per Frame: ", &Customizer.m_MaxStepsPerFrame, 0.1f, 1, c_MaxFixedStepsPerFrame);
+				Customizer.m_MaxStepsPerFrame = std::clamp(Customizer.m_MaxStepsPerFrame, 1, c_MaxFixedStepsPerFrame);
+			}
+
 			ImGui::NextColumn();
 			ImGui::TreePop();
 		}
@@ -316,12 +541,14 @@ namespace Ainan {
 		{
 			TimeTillNextParticleSpawn = abs(TimeTillNextParticleSpawn);
 
+			//count the particles due this frame and spawn them all at once
+			size_t spawnCount = 0;
 			while (TimeTillNextParticleSpawn > 0.0f) 
 			{
-				ParticleDescription p = Customizer.GetParticleDescription();
-				SpawnParticle(p);
+				spawnCount++;
 				TimeTillNextParticleSpawn -= Customizer.GetTimeBetweenParticles();
 			}
+			SpawnBatch(spawnCount);
 
 			TimeTillNextParticleSpawn = Customizer.GetTimeBetweenParticles();
 		}
@@ -4,6 +4,7 @@
 #include "editor/Window.h"
 #include "editor/EditorCamera.h"
 #include "editor/ParticleCustomizer.h"
+#include "ParticleKernels.h"
 #include "renderer/ShaderProgram.h"
 #include "renderer/Renderer.h"
 
@@ -11,7 +12,10 @@ namespace Ainan {
 
 	class ParticleSystem : public EnvironmentObjectInterface
 	{
-		const size_t c_ParticlePoolSize = 3000;
+		//the pool starts at this size and grows (by doubling) up to ParticleCustomizer::m_MaxParticleCount
+		const size_t c_InitialParticlePoolSize = 1024;
+		//particles are updated in chunks of this size on the thread pool, it's a multiple of the SIMD width
+		const size_t c_ParticleUpdateChunkSize = 4096;
 
 	public:
 		ParticleSystem();
@@ -19,10 +23,13 @@ namespace Ainan {
 
 		void Update(const float deltaTime) override;
 		void Draw() override;
+		bool GetDrawKey(DrawKey& key) override;
 		void OnTransform() override;
 		void SpawnAllParticlesOnQue(const float& deltaTime);
-		void SpawnParticle(const ParticleDescription& particle);
+		//spawns count particles at once (or as many as the particle limit allows), writing them straight into the pool
+		void SpawnBatch(size_t count);
 		void ClearParticles();
+		size_t GetParticlePoolSize() const { return m_ParticlePoolSize; }
 		void DisplayGuiControls() override;
 		int32_t GetAllowedGizmoOperation(ImGuizmo::OPERATION operation) override;
 
@@ -34,21 +41,43 @@ namespace Ainan {
 		//only for spawning on mouse press
 		bool ShouldSpawnParticles;
 		float TimeTillNextParticleSpawn = 0.0f;
+		//particles requested from the GUI with "Spawn Burst", they are spawned at the start of the next update
+		std::atomic<uint32_t> QueuedBurstParticles = 0;
+		//alive particles are always kept packed in the range [0, ActiveParticleCount) of the pool
 		uint32_t ActiveParticleCount = 0;
 
+	private:
+		//makes sure the pool can hold at least 'count' particles, growing it geometrically if needed
+		void ReserveParticlePool(size_t count);
+		//removes the particle by moving the last alive particle into its place
+		void KillParticle(size_t index);
+		ParticleArrays GetParticleArrays();
+		//moves the simulation forward by deltaTime, Update calls this once per frame or once per fixed step
+		void StepSimulation(float deltaTime);
+		//turns the customizer state into m_UpdateKernels and m_NeighborForces.
+		//all the configuration checks happen here, once per frame, and not inside the per particle loops
+		void CompileUpdateKernels(float deltaTime);
+
 	private:
 		//data for each particles
-		//NOTE the size of these vectors is c_ParticlePoolSize
+		//NOTE the size of these vectors is m_ParticlePoolSize
+		//vectors are split into x and y arrays (structure of arrays) so that the kernels can process many particles at once
 		struct ParticlesData
 		{
-			std::vector<bool> IsActive;
-			std::vector<glm::vec2> Position;
-			std::vector<glm::vec2> Velocity;
-			std::vector<glm::vec2> Acceleration;
+			std::vector<float> PositionX;
+			std::vector<float> PositionY;
+			//positions before the last step, ONLY USED WITH A FIXED TIME STEP
+			std::vector<float> PreviousPositionX;
+			std::vector<float> PreviousPositionY;
+			std::vector<float> VelocityX;
+			std::vector<float> VelocityY;
+			std::vector<float> AccelerationX;
+			std::vector<float> AccelerationY;
 			std::vector<float> StartScale;
 			std::vector<float> EndScale;
 			std::vector<float> LifeTime;
 			std::vector<float> RemainingLifeTime;
+			std::vector<float> NoiseOffset;
 		};
 
 		//buffers for rendering data
@@ -58,5 +87,20 @@ namespace Ainan {
 		size_t m_ParticleDrawCount = 0;
 
 		ParticlesData m_Particles;
+		size_t m_ParticlePoolSize = 0;
+
+		//simulation time that hasn't been stepped yet, ONLY USED WITH A FIXED TIME STEP
+		float m_TimeAccumulator = 0.0f;
+		//where to draw the particles between their previous (0) and current (1) position
+		float m_InterpolationFactor = 1.0f;
+		bool m_PreviousPositionsValid = false;
+
+		//the kernels that are run in order on every chunk of particles, rebuilt every frame by CompileUpdateKernels
+		std::vector<std::function<void(const ParticleArrays& particles, size_t begin, size_t end)>> m_UpdateKernels;
+		std::vector<NeighborForceParams> m_NeighborForces;
+		float m_MaxNeighborRadius = 0.0f;
+
+		//rebuilt every frame that has an enabled neighbor force
+		SpatialHashGrid m_NeighborGrid;
 	};
 }
\ No newline at end of file
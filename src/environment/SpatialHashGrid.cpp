@@ -0,0 +1,47 @@
+#include "SpatialHashGrid.h"
+
+namespace Ainan {
+
+	//the table has at least this many slots so that tiny point counts don't make every cell collide
+	static const uint32_t c_MinSlotCount = 64;
+
+	void SpatialHashGrid::Build(const float* positionX, const float* positionY, size_t count, float cellSize)
+	{
+		m_PointCount = count;
+		m_InverseCellSize = 1.0f / std::max(cellSize, 0.0001f);
+
+		//around two slots per point keeps collisions between different cells rare
+		uint32_t slotCount = c_MinSlotCount;
+		while (slotCount < count * 2)
+			slotCount *= 2;
+		m_SlotMask = slotCount - 1;
+
+		m_SlotStart.assign(slotCount + 1, 0);
+		m_SortedIndices.resize(count);
+		m_PointSlot.resize(count);
+
+		//count the points in every slot
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t slot = HashCell(GetCellCoordinate(positionX[i]), GetCellCoordinate(positionY[i]));
+			m_PointSlot[i] = slot;
+			m_SlotStart[slot]++;
+		}
+
+		//turn the counts into the end of every slot's range
+		uint32_t sum = 0;
+		for (uint32_t slot = 0; slot <= slotCount; slot++)
+		{
+			sum += m_SlotStart[slot];
+			m_SlotStart[slot] = sum;
+		}
+
+		//fill the slots from the back, this leaves m_SlotStart pointing at the start of every range
+		//and keeps the points of a slot in increasing index order
+		for (size_t i = count; i > 0; i--)
+		{
+			uint32_t slot = m_PointSlot[i - 1];
+			m_SortedIndices[--m_SlotStart[slot]] = (uint32_t)(i - 1);
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+namespace Ainan {
+
+	//a uniform grid over 2D points where the cells are hashed into a fixed size table, so the grid
+	//has no bounds and its memory only depends on the number of points.
+	//it is rebuilt from scratch every frame with a counting sort, which is linear in the number of points.
+	class SpatialHashGrid
+	{
+	public:
+		//puts every point in [0, count) into the cell it belongs to.
+		//cellSize should be at least the largest query radius so that a query only has to look at the 3x3 cells around it
+		void Build(const float* positionX, const float* positionY, size_t count, float cellSize);
+
+		//calls func(index) for every point in the 3x3 cells around (x, y), including the point itself if it's there.
+		//this gives candidates only, the caller still has to check the distance
+		template<typename Func>
+		void ForEachNearby(float x, float y, Func&& func) const
+		{
+			if (m_PointCount == 0)
+				return;
+
+			int32_t cellX = GetCellCoordinate(x);
+			int32_t cellY = GetCellCoordinate(y);
+
+			//two of the 9 cells can land in the same slot of the table, visit every slot only once
+			uint32_t visitedSlots[9];
+			uint32_t visitedCount = 0;
+
+			for (int32_t offsetY = -1; offsetY <= 1; offsetY++)
+			{
+				for (int32_t offsetX = -1; offsetX <= 1; offsetX++)
+				{
+					uint32_t slot = HashCell(cellX + offsetX, cellY + offsetY);
+
+					bool visited = false;
+					for (uint32_t i = 0; i < visitedCount; i++)
+						visited |= visitedSlots[i] == slot;
+					if (visited)
+						continue;
+					visitedSlots[visitedCount++] = slot;
+
+					for (uint32_t i = m_SlotStart[slot]; i < m_SlotStart[slot + 1]; i++)
+						func(m_SortedIndices[i]);
+				}
+			}
+		}
+
+		size_t GetPointCount() const { return m_PointCount; }
+
+	private:
+		int32_t GetCellCoordinate(float value) const
+		{
+			return (int32_t)std::floor(value * m_InverseCellSize);
+		}
+
+		uint32_t HashCell(int32_t cellX, int32_t cellY) const
+		{
+			return (((uint32_t)cellX * 73856093u) ^ ((uint32_t)cellY * 19349663u)) & m_SlotMask;
+		}
+
+	private:
+		float m_InverseCellSize = 1.0f;
+		size_t m_PointCount = 0;
+		uint32_t m_SlotMask = 0;
+
+		//the points in slot s are m_SortedIndices[m_SlotStart[s]] up to (not including) m_SortedIndices[m_SlotStart[s + 1]]
+		std::vector<uint32_t> m_SlotStart;
+		std::vector<uint32_t> m_SortedIndices;
+		//slot of every point, kept between the two passes of the sort
+		std::vector<uint32_t> m_PointSlot;
+	};
+}
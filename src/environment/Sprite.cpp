@@ -8,16 +8,26 @@ namespace Ainan {
 		Space = OBJ_SPACE_2D;
 		m_Name = "Sprite";
 
-		Image img = Image::LoadFromFile("res/CheckerBoard.png");
-
-		Image::GrayScaleToRGBA(img);
+		LoadTextureFromFile("res/CheckerBoard.png");
+	}
 
-		m_Texture = Renderer::CreateTexture(img);
+	Sprite::Sprite(const Sprite& sprite) :
+		EnvironmentObjectInterface(sprite),
+		Tint(sprite.Tint),
+		m_TexturePath(sprite.m_TexturePath)
+	{
+		if (m_TexturePath == "")
+			LoadTextureFromFile("res/CheckerBoard.png");
+		else
+			LoadTextureFromFile(AssetManager::s_EnvironmentDirectory.u8string() + "\\" + m_TexturePath.u8string());
 	}
 
 	Sprite::~Sprite()
 	{
-		Renderer::DestroyTexture(m_Texture);
+		if (m_Texture.IsValid())
+			Renderer::DestroyTexture(m_Texture);
+		if (!m_TextureAtlasName.empty())
+			Renderer::RemoveFromTextureAtlas(m_TextureAtlasName);
 	}
 
 	void Sprite::Update(const float deltaTime)
@@ -40,10 +50,22 @@ namespace Ainan {
 
 		if (Space == OBJ_SPACE_2D)
 		{
-			Renderer::DrawQuad(translation, Tint, scaleAverage, glm::eulerAngles(rotation).z, m_Texture);
+			Renderer::DrawQuad(translation, Tint, scaleAverage, glm::eulerAngles(rotation).z, m_TextureRegion);
 		}
 	}
 
+	bool Sprite::GetDrawKey(DrawKey& key)
+	{
+		if (Space != OBJ_SPACE_2D)
+			return false;
+
+		key.Blended = true;
+		key.Shader = Renderer::Rdata->ShaderLibrary["QuadBatchShader"].Identifier;
+		key.Texture = m_TextureRegion.Page.Identifier;
+		key.Depth = ModelMatrix[3].z;
+		return true;
+	}
+
 	void Sprite::DisplayGuiControls()
 	{
 		DisplayTransformationControls();
@@ -85,7 +107,8 @@ namespace Ainan {
 		ImGui::NextColumn();
 		ImGui::Text("Texture Preview: ");
 		ImGui::NextColumn();
-		ImGui::Image((void*)m_Texture.GetTextureID(), ImVec2(100, 100), ImVec2(0, 0), ImVec2(1, 1), ImVec4(1, 1, 1, 1), ImVec4(1, 1, 1, 1));
+		ImGui::Image((void*)m_TextureRegion.Page.GetTextureID(), ImVec2(100, 100),
+			ImVec2(m_TextureRegion.UVMin.x, m_TextureRegion.UVMin.y), ImVec2(m_TextureRegion.UVMax.x, m_TextureRegion.UVMax.y), ImVec4(1, 1, 1, 1), ImVec4(1, 1, 1, 1));
 
 		ImGui::NextColumn();
 		ImGui::Text("Tint: ");
@@ -115,10 +138,28 @@ namespace Ainan {
 
 	void Sprite::LoadTextureFromFile(const std::string& path)
 	{
-		Renderer::DestroyTexture(m_Texture);
+		if (m_Texture.IsValid())
+		{
+			Renderer::DestroyTexture(m_Texture);
+			m_Texture = Texture();
+		}
+		if (!m_TextureAtlasName.empty())
+		{
+			Renderer::RemoveFromTextureAtlas(m_TextureAtlasName);
+			m_TextureAtlasName.clear();
+		}
 
 		Image img = Image::LoadFromFile(path, TextureFormat::RGBA);
 
-		m_Texture = Renderer::CreateTexture(img);
+		std::string atlasName = TextureAtlas::GetImageName(path);
+		m_TextureRegion = Renderer::AddToTextureAtlas(atlasName, img);
+		if (m_TextureRegion.IsValid())
+			m_TextureAtlasName = atlasName;
+		else
+		{
+			m_Texture = Renderer::CreateTexture(img);
+			m_TextureRegion = AtlasRegion();
+			m_TextureRegion.Page = m_Texture;
+		}
 	}
 }
\ No newline at end of file
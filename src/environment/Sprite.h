@@ -11,10 +11,13 @@ namespace Ainan {
 	{
 	public:
 		Sprite();
+		//loads the texture again so that the copy has its own texture and atlas name to give back
+		Sprite(const Sprite& sprite);
 		~Sprite();
 
 		virtual void Update(const float deltaTime) override;
 		virtual void Draw() override;
+		virtual bool GetDrawKey(DrawKey& key) override;
 		virtual void DisplayGuiControls() override;
 		int32_t GetAllowedGizmoOperation(ImGuizmo::OPERATION operation) override;
 
@@ -25,6 +28,10 @@ namespace Ainan {
 
 		std::filesystem::path m_TexturePath; //relative to the environment folder
 	private:
+		//the texture of the sprite is in the texture atlas, or in m_Texture if it's too big for the atlas
+		AtlasRegion m_TextureRegion;
 		Texture m_Texture;
+		//the name m_TextureRegion was added to the atlas with, empty if it isn't in the atlas
+		std::string m_TextureAtlasName;
 	};
 }
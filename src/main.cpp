@@ -1,9 +1,11 @@
 #include "editor/Window.h"
 #include "editor/Editor.h"
 #include "editor/EditorPreferences.h"
+#include "editor/HeadlessExport.h"
 #include "renderer/Renderer.h"
+#include "ThreadPool.h"
 
-int main() 
+int main(int argc, char** argv) 
 {
 	using namespace Ainan;
 
@@ -11,8 +13,27 @@ int main()
 	InitAinanLogger();;
 #endif // !NDEBUG
 
+	HeadlessExportSettings headlessSettings;
+	if (ParseHeadlessExportArguments(argc, argv, headlessSettings))
+	{
+		if (!headlessSettings.ArgumentsValid)
+			return 1;
+
+		ThreadPool::Init();
+		Window::InitHeadless(glm::vec2(1920, 1080));
+		Renderer::Init(RendererType::OpenGL);
+
+		int result = RunHeadlessExport(headlessSettings);
+
+		Renderer::Terminate();
+		Window::Terminate();
+		ThreadPool::Terminate();
+		return result;
+	}
+
 	auto api = EditorPreferences::LoadFromDefaultPath().RenderingBackend;
 
+	ThreadPool::Init();
 	Window::Init(api);
 	Renderer::Init(api);
 	
@@ -36,4 +57,5 @@ int main()
 	delete editor;
 	Renderer::Terminate();
 	Window::Terminate();
+	ThreadPool::Terminate();
 }
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Interpolation.h"
+
+namespace Ainan {
+
+	//a curve over t in [0, 1] baked into evenly spaced samples and read back with linear filtering.
+	//this is so that curves are evaluated a few hundred times when they change instead of once per particle every frame
+	class CurveLUT
+	{
+	public:
+		static constexpr int32_t c_Size = 256;
+
+		//curve is called with t from 0 to 1 and returns the value of the curve at t
+		template<typename Func>
+		void Bake(Func&& curve)
+		{
+			for (int32_t i = 0; i < c_Size; i++)
+				m_Values[i] = curve((float)i / (c_Size - 1));
+			m_Values[c_Size] = m_Values[c_Size - 1];
+		}
+
+		//bakes one of the built in interpolation curves going from 0 to 1, the type is only switched on once and not per sample
+		void Bake(InterpolationType type)
+		{
+			switch (type)
+			{
+			case InterpolationType::Fixed:
+				Bake([](float t) { return Interpolation::Interpolate<InterpolationType::Fixed>(0.0f, 1.0f, t); });
+				break;
+
+			case InterpolationType::Linear:
+				Bake([](float t) { return Interpolation::Interpolate<InterpolationType::Linear>(0.0f, 1.0f, t); });
+				break;
+
+			case InterpolationType::Cubic:
+				Bake([](float t) { return Interpolation::Interpolate<InterpolationType::Cubic>(0.0f, 1.0f, t); });
+				break;
+
+			case InterpolationType::Smoothstep:
+				Bake([](float t) { return Interpolation::Interpolate<InterpolationType::Smoothstep>(0.0f, 1.0f, t); });
+				break;
+
+			case InterpolationType::Custom:
+			default:
+				//custom curves are baked from the CurveEditor with the other overload
+				assert(false);
+				break;
+			}
+		}
+
+		float Sample(float t) const
+		{
+			//NaN (from a lifetime of 0 for example) passes through the clamp and would be used as an index
+			if (!(t > 0.0f))
+				t = 0.0f;
+
+			float position = std::clamp(t, 0.0f, 1.0f) * (c_Size - 1);
+			int32_t index = (int32_t)position;
+			float fraction = position - (float)index;
+
+			return m_Values[index] + (m_Values[index + 1] - m_Values[index]) * fraction;
+		}
+
+	private:
+		//the last sample is repeated once so that sampling at t = 1 doesn't need a bounds check
+		float m_Values[c_Size + 1] = {};
+	};
+}
@@ -25,6 +25,8 @@ namespace Ainan {
 			return InterpolationType::Cubic;
 		else if (type == "Smoothstep")
 			return InterpolationType::Smoothstep;
+		else if (type == "Custom")
+			return InterpolationType::Custom;
 		else
 		{
 			assert(false);
@@ -103,5 +105,20 @@ namespace Ainan {
 			return start + diffrence * (t * t * (3 - 2 * t));
 		}
 
+		//same as Interporpolate but with the type known at compile time, so there is no switch when it's called in a loop
+		template<InterpolationType interpolationType, typename type>
+		type Interpolate(const type& start, const type& end, float t)
+		{
+			static_assert(interpolationType != Ainan::Custom, "custom curves are evaluated by the CurveEditor");
+
+			if constexpr (interpolationType == Ainan::Fixed)
+				return start;
+			else if constexpr (interpolationType == Ainan::Linear)
+				return Linear(start, end, t);
+			else if constexpr (interpolationType == Ainan::Cubic)
+				return Cubic(start, end, t);
+			else
+				return Smoothstep(start, end, t);
+		}
 	}
 }
\ No newline at end of file
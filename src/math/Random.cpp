@@ -0,0 +1,93 @@
+#include "Random.h"
+
+#include "SIMD.h"
+
+namespace Ainan {
+
+	//pcg hash from "Hash Functions for GPU Rendering" (Jarzynski and Olano, 2020)
+	static inline uint32_t PCGHash(uint32_t input)
+	{
+		uint32_t state = input * 747796405u + 2891336453u;
+		uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+		return (word >> 22u) ^ word;
+	}
+
+	//the top 24 bits fill the mantissa of a float exactly
+	static inline float UIntToUnitFloat(uint32_t value)
+	{
+		return (float)(value >> 8) * (1.0f / 16777216.0f);
+	}
+
+#if AINAN_SIMD_X86
+	//8 numbers at a time, the same operations as PCGHash and UIntToUnitFloat
+	AINAN_TARGET_AVX2
+	static size_t NextFloatsAVX2(uint32_t key, uint32_t counter, float* result, size_t count)
+	{
+		const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		const __m256i multiplier = _mm256_set1_epi32((int32_t)747796405u);
+		const __m256i increment = _mm256_set1_epi32((int32_t)2891336453u);
+		const __m256i wordMultiplier = _mm256_set1_epi32((int32_t)277803737u);
+		const __m256i four = _mm256_set1_epi32(4);
+		const __m256 floatScale = _mm256_set1_ps(1.0f / 16777216.0f);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i input = _mm256_add_epi32(_mm256_set1_epi32((int32_t)(counter + (uint32_t)i + key)), laneOffsets);
+
+			__m256i state = _mm256_add_epi32(_mm256_mullo_epi32(input, multiplier), increment);
+			__m256i shift = _mm256_add_epi32(_mm256_srli_epi32(state, 28), four);
+			__m256i word = _mm256_mullo_epi32(_mm256_xor_si256(_mm256_srlv_epi32(state, shift), state), wordMultiplier);
+			__m256i hash = _mm256_xor_si256(_mm256_srli_epi32(word, 22), word);
+
+			//the value is below 2^24 after the shift, so the signed conversion is exact
+			__m256 value = _mm256_cvtepi32_ps(_mm256_srli_epi32(hash, 8));
+			_mm256_storeu_ps(result + i, _mm256_mul_ps(value, floatScale));
+		}
+
+		return i;
+	}
+#endif
+
+	RandomStream::RandomStream(uint32_t seed)
+	{
+		SetSeed(seed);
+	}
+
+	void RandomStream::SetSeed(uint32_t seed)
+	{
+		m_Seed = seed;
+		m_Key = PCGHash(seed);
+		m_Counter = 0;
+	}
+
+	uint32_t RandomStream::NextUInt()
+	{
+		return PCGHash(m_Counter++ + m_Key);
+	}
+
+	float RandomStream::NextFloat()
+	{
+		return UIntToUnitFloat(NextUInt());
+	}
+
+	float RandomStream::NextFloat(float min, float max)
+	{
+		return min + (max - min) * NextFloat();
+	}
+
+	void RandomStream::NextFloats(float* result, size_t count)
+	{
+		size_t i = 0;
+
+#if AINAN_SIMD_X86
+		if (GetSIMDLevel() >= SIMDLevel::AVX2)
+			i = NextFloatsAVX2(m_Key, m_Counter, result, count);
+#endif
+
+		for (; i < count; i++)
+			result[i] = UIntToUnitFloat(PCGHash(m_Counter + (uint32_t)i + m_Key));
+
+		m_Counter += (uint32_t)count;
+	}
+}
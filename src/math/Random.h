@@ -0,0 +1,33 @@
+#pragma once
+
+namespace Ainan {
+
+	//a counter based random number generator (a PCG hash of seed and position in the stream).
+	//the n-th number only depends on the seed and n, so the same seed always gives the same numbers
+	//and a batch of numbers can be generated at once with SIMD instead of one after another.
+	class RandomStream
+	{
+	public:
+		RandomStream(uint32_t seed = 0);
+
+		//also restarts the stream from its first number
+		void SetSeed(uint32_t seed);
+		uint32_t GetSeed() const { return m_Seed; }
+
+		uint32_t NextUInt();
+		//uniform in [0, 1)
+		float NextFloat();
+		//uniform in [min, max)
+		float NextFloat(float min, float max);
+
+		//writes the next count numbers of the stream (uniform in [0, 1)) to result.
+		//gives exactly the same numbers as calling NextFloat count times
+		void NextFloats(float* result, size_t count);
+
+	private:
+		uint32_t m_Seed = 0;
+		//the seed hashed once, so that close seeds don't give related streams
+		uint32_t m_Key = 0;
+		uint32_t m_Counter = 0;
+	};
+}
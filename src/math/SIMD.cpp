@@ -0,0 +1,75 @@
+#include "SIMD.h"
+
+#if AINAN_SIMD_X86 && defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace Ainan {
+
+	static SIMDLevel DetectSIMDLevel()
+	{
+#if AINAN_SIMD_X86 && defined(_MSC_VER)
+		int32_t info[4] = {};
+		__cpuid(info, 0);
+		int32_t maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool sse41 = (info[2] & (1 << 19)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+
+		//AVX registers are only usable if the OS saves them on context switches
+		bool osSupportsAVX = osxsave && avx && ((_xgetbv(0) & 0x6) == 0x6);
+
+		bool avx2 = false;
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+
+		if (avx2 && osSupportsAVX)
+			return SIMDLevel::AVX2;
+		if (sse41)
+			return SIMDLevel::SSE41;
+		if (sse2)
+			return SIMDLevel::SSE2;
+		return SIMDLevel::Scalar;
+#elif AINAN_SIMD_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return SIMDLevel::AVX2;
+		if (__builtin_cpu_supports("sse4.1"))
+			return SIMDLevel::SSE41;
+		if (__builtin_cpu_supports("sse2"))
+			return SIMDLevel::SSE2;
+		return SIMDLevel::Scalar;
+#else
+		return SIMDLevel::Scalar;
+#endif
+	}
+
+	SIMDLevel GetSIMDLevel()
+	{
+		static const SIMDLevel level = DetectSIMDLevel();
+		return level;
+	}
+
+	const char* SIMDLevelStr(SIMDLevel level)
+	{
+		switch (level)
+		{
+		case SIMDLevel::Scalar:
+			return "Scalar";
+		case SIMDLevel::SSE2:
+			return "SSE2";
+		case SIMDLevel::SSE41:
+			return "SSE4.1";
+		case SIMDLevel::AVX2:
+			return "AVX2";
+		default:
+			return "";
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+//x86 intrinsics only exist on x86/x64 targets, on other targets everything uses the scalar code paths
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define AINAN_SIMD_X86 1
+	#include <immintrin.h>
+#else
+	#define AINAN_SIMD_X86 0
+#endif
+
+//msvc lets any function use SSE4.1/AVX2 intrinsics, gcc and clang need the function to be compiled for that target.
+//functions marked with these MUST only be called after checking GetSIMDLevel()
+#if defined(_MSC_VER)
+	#define AINAN_TARGET_SSE41
+	#define AINAN_TARGET_AVX2
+#else
+	#define AINAN_TARGET_SSE41 __attribute__((target("sse4.1")))
+	#define AINAN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Ainan {
+
+	//ordered from the least to the most capable, so levels can be compared with >=
+	enum class SIMDLevel
+	{
+		Scalar,
+		SSE2,
+		SSE41,
+		AVX2
+	};
+
+	//the highest instruction set supported by both the CPU and the OS, detected once on the first call
+	SIMDLevel GetSIMDLevel();
+	const char* SIMDLevelStr(SIMDLevel level);
+}
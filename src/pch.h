@@ -13,6 +13,9 @@
 #include <array>
 #include <mutex>
 #include <queue>
+#include <deque>
+#include <thread>
+#include <condition_variable>
 #include <atomic>
 #include <numeric>
 #include <limits>
@@ -0,0 +1,230 @@
+#include "ColorConversion.h"
+
+#include "ThreadPool.h"
+
+namespace Ainan {
+namespace ColorConversion {
+
+	//BT.601 limited range in 8 bit fixed point. the bias of every formula includes the offset of the channel (16 or 128)
+	//and half of the divisor for rounding, it also keeps the sums positive so they can be shifted without sign issues.
+	//U and V are computed from the sum of the 4 pixels of a block, so they are divided by 4 more (shifted by 10 instead of 8)
+	const int32_t c_YR = 66, c_YG = 129, c_YB = 25;
+	const int32_t c_UR = -38, c_UG = -74, c_UB = 112;
+	const int32_t c_VR = 112, c_VG = -94, c_VB = -18;
+	const int32_t c_YBias = (16 << 8) + (1 << 7);
+	const int32_t c_UVBias = (128 << 10) + (1 << 9);
+
+	//output rows per thread pool chunk, must be even so blocks aren't split between chunks
+	const size_t c_RowsPerChunk = 64;
+
+	//converts a pair of rows from the column begin to the column width, writing 2 rows of Y and 1 row of U and V
+	using RowPairKernel = void(*)(const uint8_t* top, const uint8_t* bottom, uint8_t* yTop, uint8_t* yBottom, uint8_t* u, uint8_t* v, uint32_t begin, uint32_t width);
+
+	//scalar version, this is also used to finish the remaining columns that don't fill a whole SIMD register
+
+	static void ConvertRowPairScalar(const uint8_t* top, const uint8_t* bottom, uint8_t* yTop, uint8_t* yBottom, uint8_t* u, uint8_t* v, uint32_t begin, uint32_t width)
+	{
+		for (uint32_t x = begin; x < width; x += 2)
+		{
+			const uint8_t* p0 = top + x * 4;
+			const uint8_t* p1 = top + x * 4 + 4;
+			const uint8_t* p2 = bottom + x * 4;
+			const uint8_t* p3 = bottom + x * 4 + 4;
+
+			yTop[x] = (uint8_t)((c_YR * p0[0] + c_YG * p0[1] + c_YB * p0[2] + c_YBias) >> 8);
+			yTop[x + 1] = (uint8_t)((c_YR * p1[0] + c_YG * p1[1] + c_YB * p1[2] + c_YBias) >> 8);
+			yBottom[x] = (uint8_t)((c_YR * p2[0] + c_YG * p2[1] + c_YB * p2[2] + c_YBias) >> 8);
+			yBottom[x + 1] = (uint8_t)((c_YR * p3[0] + c_YG * p3[1] + c_YB * p3[2] + c_YBias) >> 8);
+
+			int32_t r = p0[0] + p1[0] + p2[0] + p3[0];
+			int32_t g = p0[1] + p1[1] + p2[1] + p3[1];
+			int32_t b = p0[2] + p1[2] + p2[2] + p3[2];
+			u[x / 2] = (uint8_t)((c_UR * r + c_UG * g + c_UB * b + c_UVBias) >> 10);
+			v[x / 2] = (uint8_t)((c_VR * r + c_VG * g + c_VB * b + c_UVBias) >> 10);
+		}
+	}
+
+#if AINAN_SIMD_X86
+
+	//SSE4.1 versions (8 pixels of each row at a time).
+	//pixels are widened to 16 bits as R G B A, so a multiply add with (R, G, B, 0) coefficients gives 2 sums per pixel
+	//and horizontal adds finish them
+
+	AINAN_TARGET_SSE41
+	static inline __m128i LumaSSE(__m128i pixels01, __m128i pixels23, __m128i coefficients, __m128i bias)
+	{
+		__m128i sums = _mm_hadd_epi32(_mm_madd_epi16(pixels01, coefficients), _mm_madd_epi16(pixels23, coefficients));
+		return _mm_srli_epi32(_mm_add_epi32(sums, bias), 8);
+	}
+
+	//blocks hold the sums of the 2 rows, 2 pixels each, so adding the 2 pixels of every block gives the sum of the 2x2 block
+	AINAN_TARGET_SSE41
+	static inline __m128i ChromaSSE(const __m128i* blocks, __m128i coefficients, __m128i bias)
+	{
+		__m128i pixels0123 = _mm_hadd_epi32(_mm_madd_epi16(blocks[0], coefficients), _mm_madd_epi16(blocks[1], coefficients));
+		__m128i pixels4567 = _mm_hadd_epi32(_mm_madd_epi16(blocks[2], coefficients), _mm_madd_epi16(blocks[3], coefficients));
+		return _mm_srli_epi32(_mm_add_epi32(_mm_hadd_epi32(pixels0123, pixels4567), bias), 10);
+	}
+
+	AINAN_TARGET_SSE41
+	static void ConvertRowPairSSE(const uint8_t* top, const uint8_t* bottom, uint8_t* yTop, uint8_t* yBottom, uint8_t* u, uint8_t* v, uint32_t begin, uint32_t width)
+	{
+		const __m128i yCoefficients = _mm_setr_epi16(c_YR, c_YG, c_YB, 0, c_YR, c_YG, c_YB, 0);
+		const __m128i uCoefficients = _mm_setr_epi16(c_UR, c_UG, c_UB, 0, c_UR, c_UG, c_UB, 0);
+		const __m128i vCoefficients = _mm_setr_epi16(c_VR, c_VG, c_VB, 0, c_VR, c_VG, c_VB, 0);
+		const __m128i yBias = _mm_set1_epi32(c_YBias);
+		const __m128i uvBias = _mm_set1_epi32(c_UVBias);
+
+		uint32_t x = begin;
+		for (; x + 8 <= width; x += 8)
+		{
+			__m128i topPixels[2] = { _mm_loadu_si128((const __m128i*)(top + x * 4)), _mm_loadu_si128((const __m128i*)(top + x * 4 + 16)) };
+			__m128i bottomPixels[2] = { _mm_loadu_si128((const __m128i*)(bottom + x * 4)), _mm_loadu_si128((const __m128i*)(bottom + x * 4 + 16)) };
+
+			//2 pixels per register
+			__m128i topWide[4];
+			__m128i bottomWide[4];
+			__m128i blocks[4];
+			for (int32_t i = 0; i < 4; i++)
+			{
+				__m128i topHalf = i % 2 == 0 ? topPixels[i / 2] : _mm_srli_si128(topPixels[i / 2], 8);
+				__m128i bottomHalf = i % 2 == 0 ? bottomPixels[i / 2] : _mm_srli_si128(bottomPixels[i / 2], 8);
+				topWide[i] = _mm_cvtepu8_epi16(topHalf);
+				bottomWide[i] = _mm_cvtepu8_epi16(bottomHalf);
+				blocks[i] = _mm_add_epi16(topWide[i], bottomWide[i]);
+			}
+
+			__m128i topLuma = _mm_packs_epi32(LumaSSE(topWide[0], topWide[1], yCoefficients, yBias), LumaSSE(topWide[2], topWide[3], yCoefficients, yBias));
+			__m128i bottomLuma = _mm_packs_epi32(LumaSSE(bottomWide[0], bottomWide[1], yCoefficients, yBias), LumaSSE(bottomWide[2], bottomWide[3], yCoefficients, yBias));
+			_mm_storel_epi64((__m128i*)(yTop + x), _mm_packus_epi16(topLuma, topLuma));
+			_mm_storel_epi64((__m128i*)(yBottom + x), _mm_packus_epi16(bottomLuma, bottomLuma));
+
+			//U in the low 4 bytes and V in the next 4
+			__m128i uv = _mm_packs_epi32(ChromaSSE(blocks, uCoefficients, uvBias), ChromaSSE(blocks, vCoefficients, uvBias));
+			uv = _mm_packus_epi16(uv, uv);
+			int32_t uBytes = _mm_cvtsi128_si32(uv);
+			int32_t vBytes = _mm_extract_epi32(uv, 1);
+			memcpy(u + x / 2, &uBytes, 4);
+			memcpy(v + x / 2, &vBytes, 4);
+		}
+
+		ConvertRowPairScalar(top, bottom, yTop, yBottom, u, v, x, width);
+	}
+
+	//AVX2 versions (16 pixels of each row at a time).
+	//the horizontal adds and packs work inside each 128 bit lane, so the results are put back in order with a permute at the end
+
+	AINAN_TARGET_AVX2
+	static inline __m256i LumaAVX2(__m256i pixels0123, __m256i pixels4567, __m256i coefficients, __m256i bias)
+	{
+		//lane 0 has pixels 0 1 4 5 and lane 1 has 2 3 6 7
+		__m256i sums = _mm256_hadd_epi32(_mm256_madd_epi16(pixels0123, coefficients), _mm256_madd_epi16(pixels4567, coefficients));
+		sums = _mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 1, 2, 0));
+		return _mm256_srli_epi32(_mm256_add_epi32(sums, bias), 8);
+	}
+
+	AINAN_TARGET_AVX2
+	static inline __m256i ChromaAVX2(const __m256i* blocks, __m256i coefficients, __m256i bias)
+	{
+		//after the last add lane 0 has blocks 0 2 4 6 and lane 1 has 1 3 5 7
+		__m256i pixelsA = _mm256_hadd_epi32(_mm256_madd_epi16(blocks[0], coefficients), _mm256_madd_epi16(blocks[1], coefficients));
+		__m256i pixelsB = _mm256_hadd_epi32(_mm256_madd_epi16(blocks[2], coefficients), _mm256_madd_epi16(blocks[3], coefficients));
+		__m256i sums = _mm256_permutevar8x32_epi32(_mm256_hadd_epi32(pixelsA, pixelsB), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+		return _mm256_srli_epi32(_mm256_add_epi32(sums, bias), 10);
+	}
+
+	//packs 8 sorted 32 bit values into 8 bytes
+	AINAN_TARGET_AVX2
+	static inline __m128i PackToBytesAVX2(__m256i values)
+	{
+		__m128i words = _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+		return _mm_packus_epi16(words, words);
+	}
+
+	AINAN_TARGET_AVX2
+	static void ConvertRowPairAVX2(const uint8_t* top, const uint8_t* bottom, uint8_t* yTop, uint8_t* yBottom, uint8_t* u, uint8_t* v, uint32_t begin, uint32_t width)
+	{
+		const __m256i yCoefficients = _mm256_setr_epi16(c_YR, c_YG, c_YB, 0, c_YR, c_YG, c_YB, 0, c_YR, c_YG, c_YB, 0, c_YR, c_YG, c_YB, 0);
+		const __m256i uCoefficients = _mm256_setr_epi16(c_UR, c_UG, c_UB, 0, c_UR, c_UG, c_UB, 0, c_UR, c_UG, c_UB, 0, c_UR, c_UG, c_UB, 0);
+		const __m256i vCoefficients = _mm256_setr_epi16(c_VR, c_VG, c_VB, 0, c_VR, c_VG, c_VB, 0, c_VR, c_VG, c_VB, 0, c_VR, c_VG, c_VB, 0);
+		const __m256i yBias = _mm256_set1_epi32(c_YBias);
+		const __m256i uvBias = _mm256_set1_epi32(c_UVBias);
+
+		uint32_t x = begin;
+		for (; x + 16 <= width; x += 16)
+		{
+			//4 pixels per register
+			__m256i topWide[4];
+			__m256i bottomWide[4];
+			__m256i blocks[4];
+			for (int32_t i = 0; i < 4; i++)
+			{
+				topWide[i] = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(top + x * 4 + i * 16)));
+				bottomWide[i] = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(bottom + x * 4 + i * 16)));
+				blocks[i] = _mm256_add_epi16(topWide[i], bottomWide[i]);
+			}
+
+			__m128i topLuma = _mm_unpacklo_epi64(PackToBytesAVX2(LumaAVX2(topWide[0], topWide[1], yCoefficients, yBias)),
+				PackToBytesAVX2(LumaAVX2(topWide[2], topWide[3], yCoefficients, yBias)));
+			__m128i bottomLuma = _mm_unpacklo_epi64(PackToBytesAVX2(LumaAVX2(bottomWide[0], bottomWide[1], yCoefficients, yBias)),
+				PackToBytesAVX2(LumaAVX2(bottomWide[2], bottomWide[3], yCoefficients, yBias)));
+			_mm_storeu_si128((__m128i*)(yTop + x), topLuma);
+			_mm_storeu_si128((__m128i*)(yBottom + x), bottomLuma);
+
+			_mm_storel_epi64((__m128i*)(u + x / 2), PackToBytesAVX2(ChromaAVX2(blocks, uCoefficients, uvBias)));
+			_mm_storel_epi64((__m128i*)(v + x / 2), PackToBytesAVX2(ChromaAVX2(blocks, vCoefficients, uvBias)));
+		}
+
+		ConvertRowPairScalar(top, bottom, yTop, yBottom, u, v, x, width);
+	}
+
+#endif
+
+	static RowPairKernel GetRowPairKernel()
+	{
+#if AINAN_SIMD_X86
+		SIMDLevel level = GetSIMDLevel();
+		if (level >= SIMDLevel::AVX2)
+			return ConvertRowPairAVX2;
+		if (level >= SIMDLevel::SSE41)
+			return ConvertRowPairSSE;
+#endif
+		return ConvertRowPairScalar;
+	}
+
+	void RGBAToYUV420(const FramebufferPixels& pixels, const YUV420Image& output, uint32_t rowBegin, uint32_t rowEnd)
+	{
+		assert(pixels.Width % 2 == 0 && pixels.Height % 2 == 0 && rowBegin % 2 == 0 && rowEnd % 2 == 0);
+
+		RowPairKernel kernel = GetRowPairKernel();
+		for (uint32_t row = rowBegin; row < rowEnd; row += 2)
+		{
+			uint32_t sourceRow = pixels.BottomUp ? pixels.Height - 1 - row : row;
+			const uint8_t* top = pixels.Data + (size_t)sourceRow * pixels.RowPitch;
+			const uint8_t* bottom = pixels.BottomUp ? top - pixels.RowPitch : top + pixels.RowPitch;
+
+			kernel(top, bottom,
+				output.Planes[0] + (size_t)row * output.Strides[0],
+				output.Planes[0] + (size_t)(row + 1) * output.Strides[0],
+				output.Planes[1] + (size_t)(row / 2) * output.Strides[1],
+				output.Planes[2] + (size_t)(row / 2) * output.Strides[2],
+				0, pixels.Width);
+		}
+	}
+
+	void RGBAToYUV420(const FramebufferPixels& pixels, const YUV420Image& output, bool multithreaded)
+	{
+		if (!multithreaded)
+		{
+			RGBAToYUV420(pixels, output, 0, pixels.Height);
+			return;
+		}
+
+		//chunks are counted in row pairs so every chunk starts on an even row
+		ThreadPool::ParallelFor(pixels.Height / 2, c_RowsPerChunk / 2, [&](size_t begin, size_t end)
+			{
+				RGBAToYUV420(pixels, output, (uint32_t)begin * 2, (uint32_t)end * 2);
+			});
+	}
+}
+}
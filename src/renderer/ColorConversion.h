@@ -0,0 +1,30 @@
+#pragma once
+
+#include "math/SIMD.h"
+#include "Framebuffer.h"
+
+namespace Ainan {
+
+	//the three planes of a yuv 4:2:0 image, U and V are half the width and height of Y.
+	//these map directly to the data and linesize of an AVFrame
+	struct YUV420Image
+	{
+		uint8_t* Planes[3] = { nullptr, nullptr, nullptr };
+		int32_t Strides[3] = { 0, 0, 0 }; //in bytes
+	};
+
+	//these pick an SSE4.1/AVX2 implementation if the CPU supports it and fall back to scalar code otherwise.
+	//every implementation gives the same results so they can be mixed freely
+	namespace ColorConversion {
+
+		//converts to limited range BT.601 yuv 4:2:0 in one pass, the U and V of every 2x2 block come from the average of its pixels.
+		//the output is written top to bottom, so if the pixels are bottom up (OpenGL) their rows are read from the last one,
+		//which flips the image on the way without copying it. alpha is ignored and the width and height must be even.
+		//only the rows [rowBegin, rowEnd) of the output are written and both must be even, so calls on different rows
+		//can run in parallel
+		void RGBAToYUV420(const FramebufferPixels& pixels, const YUV420Image& output, uint32_t rowBegin, uint32_t rowEnd);
+
+		//converts the whole image, if multithreaded is true the rows are split into chunks that run on the thread pool
+		void RGBAToYUV420(const FramebufferPixels& pixels, const YUV420Image& output, bool multithreaded);
+	}
+}
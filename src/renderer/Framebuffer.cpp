@@ -0,0 +1,139 @@
+#include "Framebuffer.h"
+
+#include "Renderer.h"
+
+namespace Ainan
+{
+    void Framebuffer::Resize(const glm::vec2& newSize)
+    {
+        RenderCommand cmd;
+        cmd.Type = RenderCommandType::ResizeFramebuffer;
+        cmd.ResizeFramebufferCmdDesc.Width = newSize.x;
+        cmd.ResizeFramebufferCmdDesc.Height = newSize.y;
+        Renderer::Rdata->Framebuffers[Identifier].Size = newSize;
+        cmd.ResizeFramebufferCmdDesc.Buffer = &Renderer::Rdata->Framebuffers[Identifier];
+
+        Renderer::PushCommand(cmd);
+    }
+
+    void* Framebuffer::GetTextureID()
+    {
+        //TODO clean this
+        if(Renderer::Rdata->API == RendererType::D3D11)
+            return (void*)Renderer::Rdata->Framebuffers[Identifier].ResourceIdentifier;
+
+        return (void*)Renderer::Rdata->Framebuffers[Identifier].TextureIdentifier;
+    }
+
+    glm::vec2 Framebuffer::GetSize() const
+    {
+        return Renderer::Rdata->Framebuffers[Identifier].Size;
+    }
+
+    Image* Framebuffer::ReadPixels(glm::vec2 bottomLeftPixel, glm::vec2 topRightPixel)
+    {
+        RenderCommand cmd;
+        cmd.Type = RenderCommandType::ReadFramebuffer;
+        cmd.ReadFramebufferCmdDesc.Buffer = &Renderer::Rdata->Framebuffers[Identifier];
+        cmd.ReadFramebufferCmdDesc.Output = new Image;
+        cmd.ReadFramebufferCmdDesc.BottomLeftX = bottomLeftPixel.x;
+        cmd.ReadFramebufferCmdDesc.BottomLeftY = bottomLeftPixel.y;
+        cmd.ReadFramebufferCmdDesc.TopRightX = topRightPixel.x;
+        cmd.ReadFramebufferCmdDesc.TopRightY = topRightPixel.y;
+
+        Renderer::PushCommand(cmd);
+        Renderer::WaitUntilRendererIdle();
+        return (Image*)cmd.ReadFramebufferCmdDesc.Output;
+    }
+
+    void Framebuffer::Bind() const
+    {
+        RenderCommand cmd;
+        cmd.Type = RenderCommandType::BindFramebufferAsRenderTarget;
+        cmd.BindFramebufferAsRenderTargetCmdDesc.Buffer = &Renderer::Rdata->Framebuffers[Identifier];
+
+        Renderer::PushCommand(cmd);
+    }
+
+    FramebufferReadback::FramebufferReadback(uint32_t slotCount) :
+        m_Slots(std::make_unique<ReadbackBufferDataView[]>(slotCount)),
+        m_SlotCount(slotCount)
+    {
+        assert(slotCount > 0);
+    }
+
+    FramebufferReadback::~FramebufferReadback()
+    {
+        for (uint32_t i = 0; i < m_SlotCount; i++)
+        {
+            if (m_Slots[i].Identifier == 0)
+                continue;
+
+            RenderCommand cmd;
+            cmd.Type = RenderCommandType::DestroyReadbackBuffer;
+            cmd.DestroyReadbackBufferCmdDesc.Buffer = &m_Slots[i];
+            Renderer::PushCommand(cmd);
+        }
+
+        //the slots are owned by this object so the renderer thread has to be done with them before they are freed
+        Renderer::WaitUntilRendererIdle();
+    }
+
+    void FramebufferReadback::Start(Framebuffer framebuffer)
+    {
+        assert(m_PendingCount < m_SlotCount);
+
+        ReadbackBufferDataView& slot = m_Slots[m_NextSlot];
+        slot.Fence.Signaled = false;
+
+        RenderCommand cmd;
+        cmd.Type = RenderCommandType::ReadFramebufferAsync;
+        cmd.ReadFramebufferAsyncCmdDesc.Buffer = &Renderer::Rdata->Framebuffers[framebuffer.Identifier];
+        cmd.ReadFramebufferAsyncCmdDesc.Output = &slot;
+        Renderer::PushCommand(cmd);
+
+        m_NextSlot = (m_NextSlot + 1) % m_SlotCount;
+        m_PendingCount++;
+    }
+
+    void FramebufferReadback::Prefetch()
+    {
+        if (m_RequestedCount == m_PendingCount)
+            return;
+
+        RenderCommand cmd;
+        cmd.Type = RenderCommandType::MapReadbackBuffer;
+        cmd.MapReadbackBufferCmdDesc.Buffer = &m_Slots[(m_NextSlot + m_SlotCount - m_PendingCount + m_RequestedCount) % m_SlotCount];
+        Renderer::PushCommand(cmd);
+        m_RequestedCount++;
+    }
+
+    FramebufferPixels FramebufferReadback::Collect()
+    {
+        assert(m_PendingCount > 0);
+
+        ReadbackBufferDataView& slot = m_Slots[(m_NextSlot + m_SlotCount - m_PendingCount) % m_SlotCount];
+        if (!slot.Fence.Signaled.load(std::memory_order_acquire))
+        {
+            if (m_RequestedCount == 0)
+                Prefetch();
+
+            //submitting waits until the commands submitted before are executed, this is enough if the read was prefetched
+            //with an earlier frame. the read was started SlotCount - 1 frames ago so the gpu is usually done with it
+            Renderer::SubmitCommands();
+            if (!slot.Fence.Signaled.load(std::memory_order_acquire))
+                Renderer::WaitUntilRendererIdle();
+        }
+        m_RequestedCount--;
+        m_PendingCount--;
+
+        FramebufferPixels pixels;
+        pixels.Data = slot.MappedData;
+        pixels.Width = (uint32_t)slot.Size.x;
+        pixels.Height = (uint32_t)slot.Size.y;
+        pixels.RowPitch = slot.RowPitch;
+        pixels.BottomUp = Renderer::Rdata->API == RendererType::OpenGL;
+
+        return pixels;
+    }
+}
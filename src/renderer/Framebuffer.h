@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Image.h"
+#include "VertexBuffer.h"
+
+namespace Ainan {
+
+	class Framebuffer
+	{
+	public:
+		//This is used by the renderer to interact with the abstracted uniform buffer
+		uint32_t Identifier = 0;
+
+		void Resize(const glm::vec2& newSize);
+
+		void* GetTextureID();
+		glm::vec2 GetSize() const;
+
+		//will read the entire framebuffer if no arguments are specified
+		//returns an image that should be freed with delete
+		Image* ReadPixels(glm::vec2 bottomLeftPixel = { 0,0 }, glm::vec2 topRightPixel = { 0,0 });
+
+		void Bind() const;
+	};
+
+	struct FramebufferDataView
+	{
+		uint64_t Identifier = 0;
+		uint64_t TextureIdentifier = 0;
+		uint64_t SamplerIdentifier = 0;
+		uint64_t ResourceIdentifier = 0;
+		glm::vec2 Size;
+		bool Deleted = false;
+	};
+
+	//memory the gpu copies a framebuffer into so the cpu can read it later without stalling on the copy.
+	//on OpenGL this is a persistently mapped pixel pack buffer, on D3D11 a staging texture that is mapped once the copy is done
+	struct ReadbackBufferDataView
+	{
+		uint64_t Identifier = 0;
+		glm::vec2 Size = { 0.0f, 0.0f };
+		//only valid after the copy is done (Fence.Signaled is true)
+		uint8_t* MappedData = nullptr;
+		uint32_t RowPitch = 0; //in bytes
+		FenceDataView Fence;
+	};
+
+	//pixels of a finished framebuffer readback, in RGBA8
+	struct FramebufferPixels
+	{
+		const uint8_t* Data = nullptr;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint32_t RowPitch = 0; //in bytes, can be more than Width * 4
+		//the first row is the bottom of the image, this is the case in OpenGL
+		bool BottomUp = false;
+	};
+
+	//a ring of readback buffers used to read a framebuffer every frame without waiting for the gpu.
+	//Start copies the framebuffer into the next free slot and returns right away, Collect gives the oldest copy
+	//so the frame read with Start is collected after SlotCount - 1 more frames are started, by then the gpu is done with it.
+	//the buffers are kept between reads and only made again when the framebuffer size changes
+	class FramebufferReadback
+	{
+	public:
+		static constexpr uint32_t c_DefaultSlotCount = 3;
+
+		FramebufferReadback(uint32_t slotCount = c_DefaultSlotCount);
+		~FramebufferReadback();
+
+		FramebufferReadback(const FramebufferReadback&) = delete;
+		FramebufferReadback& operator=(const FramebufferReadback&) = delete;
+
+		//all the slots must not be pending, Collect the oldest one first if they are
+		void Start(Framebuffer framebuffer);
+		//asks the renderer thread to wait for the oldest read that wasn't asked for yet, call this after Start and before
+		//submitting the frame so a later Collect finds the read already done instead of waiting for the renderer thread
+		void Prefetch();
+		//waits for the oldest pending read if the gpu isn't done with it yet.
+		//the pixels stay valid until Start is called SlotCount more times
+		FramebufferPixels Collect();
+
+		uint32_t GetPendingCount() const { return m_PendingCount; }
+		uint32_t GetSlotCount() const { return m_SlotCount; }
+		bool IsFull() const { return m_PendingCount == m_SlotCount; }
+
+	private:
+		std::unique_ptr<ReadbackBufferDataView[]> m_Slots;
+		uint32_t m_SlotCount = 0;
+		uint32_t m_NextSlot = 0;
+		uint32_t m_PendingCount = 0;
+		//the oldest pending reads that were already asked for with Prefetch or Collect
+		uint32_t m_RequestedCount = 0;
+	};
+}
@@ -7,22 +7,23 @@ namespace Ainan {
 	//this runs on a seperate thread to not block the program
 	//this will call delete[] on the dataCpy, so you should first copy the data to a seperate buffer with new then pass it here.
 	//that is to make sure we dont have threading problems
-	static void t_SaveToFile(std::string path, int width, int height, int comp, unsigned char* dataCpy, ImageFormat format)
+	static bool t_SaveToFile(std::string path, int width, int height, int comp, unsigned char* dataCpy, ImageFormat format)
 	{
 		stbi_flip_vertically_on_write(true);
 
+		int result = 0;
 		switch (format)
 		{
 		case ImageFormat::png:
-			stbi_write_png(path.c_str(), width, height, comp, dataCpy, width * comp);
+			result = stbi_write_png(path.c_str(), width, height, comp, dataCpy, width * comp);
 			break;
 
 		case ImageFormat::jpeg:
-			stbi_write_jpg(path.c_str(), width, height, comp, dataCpy, 100);
+			result = stbi_write_jpg(path.c_str(), width, height, comp, dataCpy, 100);
 			break;
 
 		case ImageFormat::bmp:
-			stbi_write_bmp(path.c_str(), width, height, comp, dataCpy);
+			result = stbi_write_bmp(path.c_str(), width, height, comp, dataCpy);
 			break;
 
 		default:
@@ -30,6 +31,7 @@ namespace Ainan {
 		}
 
 		delete[] dataCpy;
+		return result != 0;
 	}
 
 	Image::~Image()
@@ -97,14 +99,18 @@ namespace Ainan {
 		return image;
 	}
 
-	void Image::SaveToFile(const std::string& path, const ImageFormat& format)
+	bool Image::SaveToFile(const std::string& path, const ImageFormat& format, bool async)
 	{
 		uint32_t comp = GetBytesPerPixel(Format);
 
 		unsigned char* dataCpy = new unsigned char[m_Width * m_Height * comp * sizeof(unsigned char)];
 		memcpy(dataCpy, m_Data, m_Width * m_Height * comp * sizeof(unsigned char));
+		if (!async)
+			return t_SaveToFile(path, m_Width, m_Height, comp, dataCpy, format);
+
 		std::thread thread(t_SaveToFile, path, m_Width, m_Height, comp, dataCpy, format);
 		thread.detach();
+		return true;
 	}
 
 	Image::Image(const Image& image)
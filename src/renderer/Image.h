@@ -57,7 +57,9 @@ namespace Ainan {
 
 		static Image LoadFromFile(const std::string& pathAndName, TextureFormat desiredFormat = TextureFormat::Unspecified, bool flip = true);
 		static Image FromColor(const glm::vec4& color, TextureFormat format, const glm::vec2 size);
-		void SaveToFile(const std::string& pathAndName, const ImageFormat& format);
+		//the file is written on another thread unless async is false, then this returns false if it couldn't be written.
+		//nothing waits for the other thread, so don't use async if the app can exit right after this
+		bool SaveToFile(const std::string& pathAndName, const ImageFormat& format, bool async = true);
 
 		Image(Image& image);
 		Image(const Image& image);
@@ -0,0 +1,66 @@
+#include "LinearAllocator.h"
+
+namespace Ainan {
+
+	LinearAllocator::LinearAllocator(size_t blockSize) :
+		m_BlockSize(blockSize)
+	{
+	}
+
+	LinearAllocator::~LinearAllocator()
+	{
+		for (Block& block : m_Blocks)
+			delete[] block.Data;
+	}
+
+	void* LinearAllocator::Allocate(size_t size, size_t alignment)
+	{
+		assert(alignment <= alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0);
+
+		while (m_CurrentBlock < m_Blocks.size())
+		{
+			Block& block = m_Blocks[m_CurrentBlock];
+			size_t offset = (m_CurrentOffset + alignment - 1) & ~(alignment - 1);
+			if (offset + size <= block.Size)
+			{
+				m_CurrentOffset = offset + size;
+				m_UsedMemory += size;
+				return block.Data + offset;
+			}
+
+			//go to the next block kept from the last frame, the rest of this one is wasted
+			m_CurrentBlock++;
+			m_CurrentOffset = 0;
+		}
+
+		//allocations bigger than a block get a block of their own
+		Block block;
+		block.Size = std::max(size, m_BlockSize);
+		//new[] returns memory aligned for any fundamental type
+		block.Data = new uint8_t[block.Size];
+		m_Blocks.push_back(block);
+
+		m_CurrentBlock = m_Blocks.size() - 1;
+		m_CurrentOffset = size;
+		m_UsedMemory += size;
+		return block.Data;
+	}
+
+	void LinearAllocator::Reset()
+	{
+		//free the oversized blocks so that one big upload doesn't keep its memory forever
+		auto oversized = std::remove_if(m_Blocks.begin(), m_Blocks.end(), [this](const Block& block)
+			{
+				if (block.Size <= m_BlockSize)
+					return false;
+
+				delete[] block.Data;
+				return true;
+			});
+		m_Blocks.erase(oversized, m_Blocks.end());
+
+		m_CurrentBlock = 0;
+		m_CurrentOffset = 0;
+		m_UsedMemory = 0;
+	}
+}
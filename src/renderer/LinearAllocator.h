@@ -0,0 +1,46 @@
+#pragma once
+
+namespace Ainan {
+
+	//a bump allocator that hands out memory from big blocks and frees everything at once with Reset.
+	//it's meant for memory that lives as long as a frame, allocating is a pointer increment and
+	//nothing is freed one by one, so the memory must not need destructors
+	class LinearAllocator
+	{
+	public:
+		LinearAllocator(size_t blockSize = 1024 * 1024);
+		~LinearAllocator();
+		LinearAllocator(const LinearAllocator&) = delete;
+		LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+		//the memory stays valid until the next Reset
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		T* Allocate(size_t count = 1)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "LinearAllocator never calls destructors");
+			return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		//makes all the memory available again, blocks of the normal size are kept so a frame that
+		//uses as much memory as the last one doesn't allocate
+		void Reset();
+
+		size_t GetUsedMemory() const { return m_UsedMemory; }
+
+	private:
+		struct Block
+		{
+			uint8_t* Data;
+			size_t Size;
+		};
+
+		size_t m_BlockSize;
+		std::vector<Block> m_Blocks;
+		//the block being allocated from and the offset of the first free byte in it
+		size_t m_CurrentBlock = 0;
+		size_t m_CurrentOffset = 0;
+		size_t m_UsedMemory = 0;
+	};
+}
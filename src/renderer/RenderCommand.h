@@ -39,16 +39,26 @@ namespace Ainan {
 		BindBackBufferAsRenderTarget,
 		ResizeFramebuffer,
 		ReadFramebuffer,
+		ReadFramebufferAsync,
+		MapReadbackBuffer,
+		DestroyReadbackBuffer,
 		DestroyFramebuffer, 
 
 		CreateTexture,
 		BindTexture,
 		UpdateTexture,
+		UpdateTextureRegion,
+		CopyTexture,
+		ClearTexture,
 		DestroyTexture,
 
 		DrawNew,
 		DrawIndexedNew,
 		DrawIndexedNewWithCustomNumberOfVertices,
+		DrawInstanced,
+
+		InsertFence,
+		WaitFence,
 
 		CustomCommand,
 		Unspecified
@@ -66,6 +76,8 @@ namespace Ainan {
 		glm::vec2 Size;
 		TextureFormat Format;
 		uint8_t* InitialData;
+		//only used in texture arrays, their InitialData is ignored
+		uint32_t Layers;
 	};
 
 	struct UniformBufferCreationInfo
@@ -82,6 +94,11 @@ namespace Ainan {
 		VertexLayout Layout;
 		ShaderProgramDataView* Shader;
 		bool Dynamic;
+		//if true every element of the buffer is used for a whole instance instead of a single vertex
+		bool PerInstance = false;
+		//if true the buffer is mapped once when created and stays mapped (see VertexBufferDataView::MappedData).
+		//apis that can't do that create a normal dynamic buffer
+		bool PersistentlyMapped = false;
 	};
 
 	struct IndexBufferCreationInfo
@@ -192,9 +209,13 @@ namespace Ainan {
 			struct UpdateVertexBufferCmdDescStruct
 			{
 				VertexBufferDataView* VertexBuffer;
+				//allocate with RenderCommandQueue::AllocatePayload, it's freed after the command is executed
 				void* Data;
 				uint32_t Size;
 				uint32_t Offset;
+				//if true draws recorded before this can still read the rest of the buffer, only the range is written.
+				//if false the old contents of the whole buffer can be thrown away (D3D11 discards them)
+				bool NoOverwrite;
 			} UpdateVertexBufferCmdDesc;
 
 			struct DestroyVertexBufferCmdDescStruct
@@ -206,7 +227,7 @@ namespace Ainan {
 			//index buffer commands
 			struct CreateIndexBufferCmdDescStruct
 			{
-				//create with new, memory is handled internally
+				//allocate with RenderCommandQueue::AllocatePayload, it's freed after the command is executed
 				IndexBufferCreationInfo* Info;
 				IndexBufferDataView* Output;
 			} CreateIndexBufferCmdDesc;
@@ -235,6 +256,7 @@ namespace Ainan {
 			struct UpdateUniformBufferCmdDescStruct
 			{
 				UniformBufferDataView* Buffer;
+				//allocate with RenderCommandQueue::AllocatePayload, it's freed after the command is executed
 				void* Data;
 			} UpdateUniformBufferCmdDesc;
 
@@ -247,7 +269,7 @@ namespace Ainan {
 			//framebuffer commands
 			struct CreateFramebufferCmdDescStruct
 			{
-				//create with new, memory is handled internally
+				//allocate with RenderCommandQueue::AllocatePayload, it's freed after the command is executed
 				FramebufferCreationInfo* Info;
 				FramebufferDataView* Output;
 			} CreateFramebufferCmdDesc;
@@ -288,6 +310,25 @@ namespace Ainan {
 				uint32_t TopRightY;
 			} ReadFramebufferCmdDesc;
 
+			//copies the whole framebuffer into Output without waiting for the copy, Output->Fence.Signaled should be set to false before pushing this.
+			//Output is made (again) if it wasn't made yet or has a different size than the framebuffer
+			struct ReadFramebufferAsyncCmdDescStruct
+			{
+				FramebufferDataView* Buffer;
+				ReadbackBufferDataView* Output;
+			} ReadFramebufferAsyncCmdDesc;
+
+			//blocks the renderer thread until the copy into Buffer is done, then sets Buffer->MappedData and Buffer->Fence.Signaled
+			struct MapReadbackBufferCmdDescStruct
+			{
+				ReadbackBufferDataView* Buffer;
+			} MapReadbackBufferCmdDesc;
+
+			struct DestroyReadbackBufferCmdDescStruct
+			{
+				ReadbackBufferDataView* Buffer;
+			} DestroyReadbackBufferCmdDesc;
+
 			struct DestroyFramebufferCmdDescStruct
 			{
 				FramebufferDataView* Buffer;
@@ -297,6 +338,7 @@ namespace Ainan {
 			//texture commands
 			struct CreateTextureCmdDescStruct
 			{
+				//allocate with RenderCommandQueue::AllocatePayload, it's freed after the command is executed
 				TextureCreationInfo* Info;
 				TextureDataView* Output;
 			} CreateTextureProgramCmdDesc;
@@ -314,10 +356,38 @@ namespace Ainan {
 				uint32_t Width;
 				uint32_t Height;
 				TextureFormat Format;
-				//create with new, memory is handled internally
+				//allocate with RenderCommandQueue::AllocatePayload, it's freed after the command is executed
 				void* Data;
 			} UpdateTextureCmdDesc;
 
+			//only for 2D textures and texture arrays with one layer, the format of the data has to be the format of the texture
+			struct UpdateTextureRegionCmdDescStruct
+			{
+				TextureDataView* Texture;
+				uint32_t X;
+				uint32_t Y;
+				uint32_t Width;
+				uint32_t Height;
+				//allocate with RenderCommandQueue::AllocatePayload, it's freed after the command is executed
+				void* Data;
+			} UpdateTextureRegionCmdDesc;
+
+			//copies whole layers (the first layer of 2D textures) between textures of the same size and format
+			struct CopyTextureCmdDescStruct
+			{
+				TextureDataView* Source;
+				uint32_t SourceLayer;
+				TextureDataView* Destination;
+				uint32_t DestinationLayer;
+				uint32_t LayerCount;
+			} CopyTextureCmdDesc;
+
+			//sets every pixel of every layer to zero
+			struct ClearTextureCmdDescStruct
+			{
+				TextureDataView* Texture;
+			} ClearTextureCmdDesc;
+
 			struct DestroyTextureCmdDescStruct
 			{
 				TextureDataView* Texture;
@@ -348,7 +418,33 @@ namespace Ainan {
 				ShaderProgramDataView* Shader;
 				Primitive DrawingPrimitive;
 				uint32_t IndexCount;
+				int32_t BaseVertex; //added to every index
 			} DrawIndexedWithCustomNumberOfVerticesCmdDesc;
+
+			//draws InstanceCount instances of VertexCount vertices each, the vertex buffer should be created as per instance
+			struct DrawInstancedCmdDescStruct
+			{
+				VertexBufferDataView* VertexBuffer;
+				ShaderProgramDataView* Shader;
+				Primitive DrawingPrimitive;
+				uint32_t VertexCount;
+				uint32_t InstanceCount;
+				uint32_t FirstInstance;
+			} DrawInstancedCmdDesc;
+
+			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			//sync commands
+			struct InsertFenceCmdDescStruct
+			{
+				//Signaled should be set to false before pushing this
+				FenceDataView* Fence;
+			} InsertFenceCmdDesc;
+
+			//blocks the renderer thread until the gpu has passed the fence, then sets Fence->Signaled
+			struct WaitFenceCmdDescStruct
+			{
+				FenceDataView* Fence;
+			} WaitFenceCmdDesc;
 			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		};
 
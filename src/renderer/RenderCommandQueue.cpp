@@ -2,54 +2,98 @@
 
 namespace Ainan {
 
-    const int32_t c_MaxQueueSize = 10;
+	//number of times a thread checks again before going to sleep, most waits are shorter than a sleep and wake up
+	const int32_t c_SpinCountBeforeSleeping = 64;
+
+	//NOTE: the sleeping flags and the counts are accessed with sequentially consistent ordering on purpose.
+	//a thread that is about to sleep sets its flag then checks the count, and the other thread sets the count then checks
+	//the flag, so either the sleeping thread sees the new count or the other thread sees the flag and wakes it up
 
 	void RenderCommandQueue::Push(const RenderCommand& cmd)
 	{
-        if (m_InternalQueue.size() >= c_MaxQueueSize)
-        {
-            std::unique_lock<std::mutex> lock(m_Mutex);
-            m_WorkConsumedCV.wait(lock, [this]() { return m_InternalQueue.size() < c_MaxQueueSize; });
-        }
-
-		std::scoped_lock<std::mutex> lock(m_Mutex);
-		m_InternalQueue.push(cmd);
-		m_WorkAvailableCV.notify_one();
+		uint64_t submittedCount = m_SubmittedCount.load(std::memory_order_relaxed);
+		m_CommandBuffers[submittedCount % c_RenderCommandBufferCount].push_back(cmd);
+	}
+
+	void RenderCommandQueue::Submit()
+	{
+		uint64_t submittedCount = m_SubmittedCount.load(std::memory_order_relaxed);
+		if (m_CommandBuffers[submittedCount % c_RenderCommandBufferCount].empty())
+			return;
+
+		m_SubmittedCount = submittedCount + 1;
+		if (m_ConsumerSleeping)
+		{
+			std::lock_guard lock(m_Mutex);
+			m_WorkAvailableCV.notify_one();
+		}
+
+		//the next buffer to record into is the one submitted before this one, wait until it's executed
+		auto isFree = [this, submittedCount]() { return m_ExecutedCount.load() >= submittedCount; };
+		for (int32_t i = 0; i < c_SpinCountBeforeSleeping && !isFree(); i++)
+			std::this_thread::yield();
+
+		if (isFree())
+			return;
+
+		std::unique_lock lock(m_Mutex);
+		m_ProducerSleeping = true;
+		m_WorkDoneCV.wait(lock, isFree);
+		m_ProducerSleeping = false;
 	}
 
 	void RenderCommandQueue::WaitUntilIdle()
 	{
-		std::unique_lock<std::mutex> lock(m_Mutex);
-        using namespace std::chrono_literals;
-		m_WorkDoneCV.wait_for(lock, 500ms, [this]() { return m_InternalQueue.empty() && (m_Busy == false); });
+		Submit();
+
+		uint64_t submittedCount = m_SubmittedCount.load(std::memory_order_relaxed);
+		auto isIdle = [this, submittedCount]() { return m_ExecutedCount.load() == submittedCount; };
+		for (int32_t i = 0; i < c_SpinCountBeforeSleeping && !isIdle(); i++)
+			std::this_thread::yield();
+
+		if (isIdle())
+			return;
+
+		std::unique_lock lock(m_Mutex);
+		m_ProducerSleeping = true;
+		m_WorkDoneCV.wait(lock, isIdle);
+		m_ProducerSleeping = false;
 	}
 
 	void RenderCommandQueue::WaitPopAndExecuteAll(std::function<void(const RenderCommand&)> func)
 	{
-        std::unique_lock<std::mutex> latch(m_Mutex);
-        using namespace std::chrono_literals;
-        m_WorkAvailableCV.wait_for(latch, 20ms, [this]() { return !m_InternalQueue.empty(); });
-        while (!m_InternalQueue.empty())
-        {
-            // got work. set busy.
-            m_Busy = true;
-
-            // pull from queue
-            auto cmd = m_InternalQueue.front();
-            m_InternalQueue.pop();
-
-            // release lock. run async
-            latch.unlock();
-            
-            m_WorkConsumedCV.notify_one();
-
-            // run function outside context
-            func(cmd);
-
-            latch.lock();
-            m_Busy = false;
-        }
-
-        m_WorkDoneCV.notify_one();
+		uint64_t executedCount = m_ExecutedCount.load(std::memory_order_relaxed);
+
+		auto isEmpty = [this, executedCount]() { return m_SubmittedCount.load() == executedCount; };
+		for (int32_t i = 0; i < c_SpinCountBeforeSleeping && isEmpty(); i++)
+			std::this_thread::yield();
+
+		if (isEmpty())
+		{
+			std::unique_lock lock(m_Mutex);
+			m_ConsumerSleeping = true;
+			//wake up every now and then even without work so the renderer thread can check if it should stop
+			using namespace std::chrono_literals;
+			m_WorkAvailableCV.wait_for(lock, 20ms, [&isEmpty]() { return !isEmpty(); });
+			m_ConsumerSleeping = false;
+
+			if (isEmpty())
+				return;
+		}
+
+		std::vector<RenderCommand>& commands = m_CommandBuffers[executedCount % c_RenderCommandBufferCount];
+		for (const RenderCommand& cmd : commands)
+			func(cmd);
+
+		//clear keeps the memory of the buffer for the next time it's recorded into
+		commands.clear();
+		m_PayloadAllocators[executedCount % c_RenderCommandBufferCount].Reset();
+
+		m_ExecutedCount = executedCount + 1;
+		if (m_ProducerSleeping)
+		{
+			std::lock_guard lock(m_Mutex);
+			m_WorkDoneCV.notify_one();
+		}
 	}
 }
\ No newline at end of file
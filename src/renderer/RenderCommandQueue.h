@@ -1,23 +1,55 @@
 #pragma once
 
 #include "RenderCommand.h"
+#include "LinearAllocator.h"
 
 namespace Ainan {
 
+	//number of command buffers, one is recorded by the main thread while the renderer thread executes the other
+	const uint32_t c_RenderCommandBufferCount = 2;
+
+	//commands are recorded by a single producer (the main thread) into a linear command buffer that is handed over to
+	//a single consumer (the renderer thread) as a whole when it is submitted, usually once every frame.
+	//the renderer thread executes frame N while the main thread records frame N + 1.
+	//the buffers are reused so recording doesn't allocate once they have grown to the size of a frame
 	class RenderCommandQueue
 	{
 	public:
+		//only call from the main thread, the command is executed after the next Submit
 		void Push(const RenderCommand& cmd);
+		//only call from the main thread, hands the recorded commands to the renderer thread.
+		//this waits if the renderer thread is still executing the previous submission
+		void Submit();
+		//only call from the main thread, submits then returns when every command pushed before this is executed
 		void WaitUntilIdle();
-		
+		//only call from the main thread, memory for the payload of a command (like the data of an update) that stays
+		//valid until the command is executed, it's freed all at once with the buffer it's recorded into so don't free it
+		template<typename T>
+		T* AllocatePayload(size_t count = 1)
+		{
+			uint64_t submittedCount = m_SubmittedCount.load(std::memory_order_relaxed);
+			return m_PayloadAllocators[submittedCount % c_RenderCommandBufferCount].Allocate<T>(count);
+		}
+
+		//only call from the renderer thread, waits a short time for a submission then executes all of its commands
 		void WaitPopAndExecuteAll(std::function<void(const RenderCommand&)> func);
 
 	private:
-		std::queue<RenderCommand> m_InternalQueue;
-		std::condition_variable m_WorkAvailableCV;
-		std::condition_variable m_WorkDoneCV;
-		std::condition_variable m_WorkConsumedCV;
-		std::mutex m_Mutex;
-		bool m_Busy = false;
+		std::array<std::vector<RenderCommand>, c_RenderCommandBufferCount> m_CommandBuffers;
+		//payloads of the commands in the command buffer with the same index, reset after the buffer is executed
+		std::array<LinearAllocator, c_RenderCommandBufferCount> m_PayloadAllocators;
+
+		//the counts only increase, submission i is in m_CommandBuffers[i % c_RenderCommandBufferCount].
+		//the main thread records into the buffer of submission m_SubmittedCount.
+		//they are on separate cache lines so the two threads don't slow each other down
+		alignas(64) std::atomic<uint64_t> m_SubmittedCount = 0; //written by the producer
+		alignas(64) std::atomic<uint64_t> m_ExecutedCount = 0; //written by the consumer
+
+		//used only for sleeping, the sleeping flags tell the other thread that it has to lock the mutex and notify
+		alignas(64) std::mutex m_Mutex;
+		std::condition_variable m_WorkAvailableCV; //the producer submitted a buffer
+		std::condition_variable m_WorkDoneCV; //the consumer finished a buffer
+		std::atomic_bool m_ConsumerSleeping = false;
+		std::atomic_bool m_ProducerSleeping = false;
 	};
-}
\ No newline at end of file
+}
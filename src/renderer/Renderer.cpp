@@ -42,6 +42,7 @@ namespace Ainan {
 		{ "GridShader"          , "shaders/Grid"          , "shaders/Grid"           },
 		{ "ImageShader"         , "shaders/Image"         , "shaders/Image"          },
 		{ "QuadBatchShader"     , "shaders/QuadBatch"     , "shaders/QuadBatch"      },
+		{ "QuadInstanceShader"  , "shaders/QuadInstance"  , "shaders/QuadBatch"      },
 		{ "LitSpriteShader"     , "shaders/LitSprite"     , "shaders/LitSprite"      },
 		{ "3DAmbientShader"     , "shaders/3DAmbient"     , "shaders/3DAmbient"      },
 		{ "SkyboxShader"        , "shaders/Skybox"        , "shaders/Skybox"         }
@@ -68,13 +69,17 @@ namespace Ainan {
 
 	void Renderer::Terminate()
 	{
-		Rdata->CurrentActiveAPI->TerminateImGui();
-		DestroyVertexBuffer(Rdata->QuadBatchVertexBuffer);
+		if (!Window::Headless)
+			Rdata->CurrentActiveAPI->TerminateImGui();
+		DestroyQuadBatchBuffers();
 		DestroyVertexBuffer(Rdata->BlurVertexBuffer);
-		DestroyIndexBuffer(Rdata->QuadBatchIndexBuffer);
 		DestroyUniformBuffer(Rdata->SceneUniformBuffer);
 		DestroyUniformBuffer(Rdata->BlurUniformBuffer);
 		DestroyTexture(Rdata->WhiteTexture);
+		Rdata->Atlas.Clear();
+		for (QuadTextureArray& array : Rdata->QuadTextureArrays)
+			if (!array.External)
+				DestroyTexture(array.Array);
 		DestroyFramebuffer(Rdata->BlurFramebuffer);
 
 		//free the shader library
@@ -87,7 +92,8 @@ namespace Ainan {
 			Renderer::PushCommand(cmd);
 		}
 
-		//signal and wait for the renderer thread to stop
+		//execute everything that is left then signal and wait for the renderer thread to stop
+		WaitUntilRendererIdle();
 		Rdata->DestroyThread = true;
 		Rdata->Thread.join();
 
@@ -194,40 +200,9 @@ namespace Ainan {
 			Rdata->ShaderLibrary[shaderInfo.Name] = CreateShaderProgram(shaderInfo.VertexCodePath, shaderInfo.FragmentCodePath);
 		}
 
-		//setup batch renderer
-		{
-			VertexLayout layout(4);
-			layout[0] = VertexLayoutElement("POSITION", 0, ShaderVariableType::Vec3);
-			layout[1] = VertexLayoutElement("NORMAL", 0, ShaderVariableType::Vec4);
-			layout[2] = VertexLayoutElement("TEXCOORD", 0, ShaderVariableType::Float);
-			layout[3] = VertexLayoutElement("TEXCOORD", 1, ShaderVariableType::Vec2);
-
-			Rdata->QuadBatchVertexBuffer = CreateVertexBuffer(nullptr, c_MaxQuadVerticesPerBatch * sizeof(QuadVertex), layout, Rdata->ShaderLibrary["QuadBatchShader"], true);
-		}
-
-		const int32_t indexCount = c_MaxQuadsPerBatch * 6;
-		uint32_t* indicies = new uint32_t[indexCount];
-		size_t u = 0;
-		for (size_t i = 0; i < indexCount; i += 6)
-		{
-			indicies[i + 0] = 0 + u;
-			indicies[i + 1] = 1 + u;
-			indicies[i + 2] = 2 + u;
-
-			indicies[i + 3] = 0 + u;
-			indicies[i + 4] = 2 + u;
-			indicies[i + 5] = 3 + u;
-			u += 4;
-		}
-
-		Rdata->QuadBatchIndexBuffer = CreateIndexBuffer(indicies, indexCount);
-		delete[] indicies;
-
-		Rdata->QuadBatchVertexBufferDataOrigin = new QuadVertex[c_MaxQuadVerticesPerBatch];
-		Rdata->QuadBatchVertexBufferDataPtr = Rdata->QuadBatchVertexBufferDataOrigin;
+		CreateQuadBatchBuffers(c_InitialQuadBatchCapacity);
 
 		Rdata->WhiteTexture = CreateTexture(glm::vec2(1, 1), TextureFormat::RGBA, TextureType::Texture2D, nullptr);
-		Rdata->QuadBatchTextures[0] = Rdata->WhiteTexture;
 
 		auto img = std::make_shared<Image>();
 		img->m_Width = 1;
@@ -235,11 +210,12 @@ namespace Ainan {
 		img->Format = TextureFormat::RGBA;
 		img->m_Data = new uint8_t[4];
 		memset(img->m_Data, (uint8_t)255, 4);
-		Rdata->QuadBatchTextures[0].UpdateData(img);
-		Rdata->QuadBatchTextureSlotsUsed = 1;
+		Rdata->WhiteTexture.UpdateData(img);
 
+		//make sure every slot has an array bound to it
+		QuadTextureLocation whiteTextureLocation = GetQuadTextureLocation(Rdata->WhiteTexture);
 		for (size_t i = 0; i < c_MaxQuadTexturesPerBatch; i++)
-			Rdata->ShaderLibrary["QuadBatchShader"].BindTexture(Rdata->WhiteTexture, i, RenderingStage::FragmentShader);
+			Rdata->ShaderLibrary["QuadBatchShader"].BindTexture(Rdata->QuadTextureArrays[whiteTextureLocation.Array].Array, i, RenderingStage::FragmentShader);
 
 		//setup postprocessing
 		Rdata->BlurFramebuffer = CreateFramebuffer(Window::FramebufferSize);
@@ -323,7 +299,9 @@ namespace Ainan {
 		}
 
 		SetBlendMode(Rdata->m_CurrentBlendMode);
-		InitImGuiRendering();
+		//headless mode has no window to show the ui in
+		if (!Window::Headless)
+			InitImGuiRendering();
 	}
 
 	void Renderer::RendererThreadLoop(RendererType api)
@@ -352,21 +330,25 @@ namespace Ainan {
 				cmd.CustomCommand();
 			else
 				Rdata->CurrentActiveAPI->ExecuteCommand(cmd);
+
+			if (cmd.Type == RenderCommandType::CreateTexture)
+				Rdata->CreatedTextureCount.fetch_add(1, std::memory_order_release);
 		};
 		while (true)
 		{
 			if (Rdata->DestroyThread)
 				break;
 			{
-				
 				Rdata->CommandQueue.WaitPopAndExecuteAll(execCmd);
+
+				//the main thread reuses a streaming region without waiting if its fence was already found to be passed
+				Rdata->CurrentActiveAPI->PollFences();
 			}
 		}
 	}
 
 	void Renderer::InternalTerminate()
 	{
-		delete[] Rdata->QuadBatchVertexBufferDataOrigin;
 		delete Rdata->CurrentActiveAPI;
 	}
 
@@ -377,12 +359,22 @@ namespace Ainan {
 
 	void Renderer::BeginScene(const SceneDescription& desc)
 	{
+		//make the batch big enough for the busiest scene so far, so a scene like it is drawn with one batch of each kind.
+		//it has some extra room so that a scene that keeps growing doesn't recreate the buffers every frame
+		if (Rdata->PeakQuadsPerScene > Rdata->QuadBatchCapacity && Rdata->QuadBatchCapacity < c_MaxQuadBatchCapacity)
+			SetQuadBatchCapacity(Rdata->PeakQuadsPerScene + Rdata->PeakQuadsPerScene / 4);
+		Rdata->QuadBatchQuadsThisScene = 0;
+		Rdata->QuadInstancesThisScene = 0;
+
 		//clear previous frame's lights
 		Rdata->CurrentSceneDescription = desc;
 		Rdata->SceneBufferData.CurrentViewProjection = desc.SceneCamera.GetViewProjectionMatrix();
 		Rdata->CurrentNumberOfDrawCalls = 0;
 		Rdata->RadialLightSubmissionCount = 0;
 		Rdata->SpotLightSubmissionCount = 0;
+		Rdata->DrawPackets.clear();
+		Rdata->DrawKeyShaderIndices.clear();
+		Rdata->DrawKeyTextureIndices.clear();
 		Rdata->SceneUniformBuffer.UpdateData(&Rdata->SceneBufferData, sizeof(RendererData::SceneUniformBufferData));
 
 		Rdata->CurrentSceneDescription.SceneDrawTarget.Bind();
@@ -425,9 +417,156 @@ namespace Ainan {
 		PushCommand(cmd);
 	}
 
+	//the key from the most significant bits: blend mode 4 | sequence 16 | shader 12 | texture 16 | depth 16
+	const uint64_t c_DrawKeyBlendModeShift = 60;
+	const uint64_t c_DrawKeySequenceShift = 44;
+	const uint64_t c_DrawKeyShaderShift = 32;
+	const uint64_t c_DrawKeyTextureShift = 16;
+	const uint32_t c_MaxDrawKeyShaders = 1 << 12;
+	const uint32_t c_MaxDrawKeyTextures = 1 << 16;
+
+	//returns the index of identifier in the current scene, giving it the next one if it wasn't used yet
+	static uint32_t GetDrawKeyIndex(std::unordered_map<uint32_t, uint32_t>& indices, uint32_t identifier, uint32_t maxIndexCount)
+	{
+		auto it = indices.find(identifier);
+		if (it != indices.end())
+			return it->second;
+
+		//draws with indices that don't fit would be sorted as if they used the same state as others
+		assert(indices.size() < maxIndexCount);
+		uint32_t index = (uint32_t)indices.size();
+		indices[identifier] = index;
+		return index;
+	}
+
+	//sequence is the number of packets submitted before this one, it's only used for blended draws.
+	//draws that aren't blended have sequence 0 so they are grouped by state no matter where they were submitted
+	static uint64_t MakeDrawKey(const DrawKey& key, RenderingBlendMode blendMode, uint32_t sequence)
+	{
+		uint64_t shaderIndex = GetDrawKeyIndex(Renderer::Rdata->DrawKeyShaderIndices, key.Shader, c_MaxDrawKeyShaders);
+		uint64_t textureIndex = GetDrawKeyIndex(Renderer::Rdata->DrawKeyTextureIndices, key.Texture, c_MaxDrawKeyTextures);
+
+		//flip the bits of the float so that comparing them as integers gives the order of the floats
+		uint32_t depthBits;
+		memcpy(&depthBits, &key.Depth, sizeof(float));
+		depthBits = (depthBits & 0x80000000) ? ~depthBits : depthBits | 0x80000000;
+
+		uint64_t sequenceBits = key.Blended ? std::min(sequence + 1, 0xFFFFu) : 0;
+
+		return (((uint64_t)blendMode & 0xF) << c_DrawKeyBlendModeShift) |
+			(sequenceBits << c_DrawKeySequenceShift) |
+			((shaderIndex & 0xFFF) << c_DrawKeyShaderShift) |
+			((textureIndex & 0xFFFF) << c_DrawKeyTextureShift) |
+			(depthBits >> 16);
+	}
+
+	//stable LSD radix sort on the keys a byte at a time
+	static void RadixSortDrawKeys(std::vector<std::pair<uint64_t, uint32_t>>& entries, std::vector<std::pair<uint64_t, uint32_t>>& buffer)
+	{
+		if (entries.empty())
+			return;
+
+		buffer.resize(entries.size());
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			std::array<uint32_t, 256> offsets = {};
+			for (auto& entry : entries)
+				offsets[(entry.first >> shift) & 0xFF]++;
+
+			//all the keys have the same byte here so this pass wouldn't move anything, this is common because few bits are used
+			if (offsets[(entries[0].first >> shift) & 0xFF] == entries.size())
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t& count : offsets)
+			{
+				uint32_t bucketSize = count;
+				count = offset;
+				offset += bucketSize;
+			}
+
+			for (auto& entry : entries)
+				buffer[offsets[(entry.first >> shift) & 0xFF]++] = entry;
+
+			entries.swap(buffer);
+		}
+	}
+
+	void Renderer::SubmitDrawPacket(const DrawKey& key, std::function<void()> draw)
+	{
+		Rdata->DrawPackets.push_back({ MakeDrawKey(key, Rdata->m_CurrentBlendMode, (uint32_t)Rdata->DrawPackets.size()), std::move(draw) });
+	}
+
+	void Renderer::DrawSortedPackets()
+	{
+		auto& packets = Rdata->DrawPackets;
+		auto& order = Rdata->DrawPacketOrder;
+
+		order.resize(packets.size());
+		for (uint32_t i = 0; i < packets.size(); i++)
+			order[i] = { packets[i].Key, i };
+
+		//count the state changes and batch breaks when drawing the keys in the order they are in now
+		//the keys hold the index the shaders got in this scene, the quad shaders may not have one if no quads were drawn
+		auto getShaderIndex = [](uint32_t identifier)
+		{
+			auto it = Rdata->DrawKeyShaderIndices.find(identifier);
+			return it == Rdata->DrawKeyShaderIndices.end() ? std::numeric_limits<uint64_t>::max() : (uint64_t)it->second;
+		};
+		const uint64_t quadBatchShader = getShaderIndex(Rdata->ShaderLibrary["QuadBatchShader"].Identifier);
+		const uint64_t quadInstanceShader = getShaderIndex(Rdata->ShaderLibrary["QuadInstanceShader"].Identifier);
+		auto countChanges = [&](uint32_t& stateChanges, uint32_t& batchBreaks)
+		{
+			stateChanges = 0;
+			batchBreaks = 0;
+			uint64_t lastQuadShader = std::numeric_limits<uint64_t>::max();
+			for (size_t i = 0; i < order.size(); i++)
+			{
+				uint64_t key = order[i].first;
+				uint64_t shader = (key >> c_DrawKeyShaderShift) & 0xFFF;
+				if (i > 0)
+				{
+					uint64_t lastKey = order[i - 1].first;
+					stateChanges += ((key >> c_DrawKeyBlendModeShift) & 0xF) != ((lastKey >> c_DrawKeyBlendModeShift) & 0xF);
+					stateChanges += shader != ((lastKey >> c_DrawKeyShaderShift) & 0xFFF);
+					stateChanges += ((key >> c_DrawKeyTextureShift) & 0xFFFF) != ((lastKey >> c_DrawKeyTextureShift) & 0xFFFF);
+				}
+
+				//other draws don't flush the quad batch, but switching between the two kinds of quads does
+				if (shader == quadBatchShader || shader == quadInstanceShader)
+				{
+					if (lastQuadShader != std::numeric_limits<uint64_t>::max() && shader != lastQuadShader)
+						batchBreaks++;
+					lastQuadShader = shader;
+				}
+			}
+		};
+
+		uint32_t unsortedStateChanges, unsortedBatchBreaks;
+		countChanges(unsortedStateChanges, unsortedBatchBreaks);
+
+		RadixSortDrawKeys(order, Rdata->DrawPacketSortBuffer);
+
+		uint32_t sortedStateChanges, sortedBatchBreaks;
+		countChanges(sortedStateChanges, sortedBatchBreaks);
+
+		for (auto& entry : order)
+			packets[entry.second].Draw();
+
+		Rdata->NumberOfDrawPacketsLastScene = (uint32_t)packets.size();
+		Rdata->StateChangesSavedLastScene = (int32_t)unsortedStateChanges - (int32_t)sortedStateChanges;
+		Rdata->DrawCallsSavedLastScene = (int32_t)unsortedBatchBreaks - (int32_t)sortedBatchBreaks;
+
+		//the functions can hold resources, don't keep them until the next scene
+		packets.clear();
+	}
+
 	void Renderer::EndScene()
 	{
-		if (Rdata->QuadBatchVertexBufferDataPtr != Rdata->QuadBatchVertexBufferDataOrigin)
+		DrawSortedPackets();
+
+		if (Rdata->QuadBatchVertexBufferDataPtr != Rdata->QuadBatchVertexBufferDataOrigin ||
+			Rdata->QuadInstanceBufferDataPtr != Rdata->QuadInstanceBufferDataOrigin)
 			FlushQuadBatch();
 		
 		if (Rdata->CurrentSceneDescription.Blur && Rdata->m_CurrentBlendMode != RenderingBlendMode::Screen)
@@ -438,6 +577,7 @@ namespace Ainan {
 		memset(&Rdata->CurrentSceneDescription, 0, sizeof(SceneDescription));
 		memset(&Rdata->SceneBufferData, 0, sizeof(Renderer::RendererData::SceneUniformBufferData));
 		Rdata->NumberOfDrawCallsLastScene = Rdata->CurrentNumberOfDrawCalls;
+		Rdata->PeakQuadsPerScene = std::max({ Rdata->PeakQuadsPerScene, Rdata->QuadBatchQuadsThisScene, Rdata->QuadInstancesThisScene });
 	}
 
 	void Renderer::WaitUntilRendererIdle()
@@ -445,36 +585,20 @@ namespace Ainan {
 		Rdata->CommandQueue.WaitUntilIdle();
 	}
 
+	void Renderer::SubmitCommands()
+	{
+		Rdata->CommandQueue.Submit();
+	}
+
 	void Renderer::DrawQuad(glm::vec3 position, glm::vec4 color, float scale, Texture texture)
 	{
-		if ((Rdata->QuadBatchVertexBufferDataPtr - Rdata->QuadBatchVertexBufferDataOrigin) / sizeof(QuadVertex) > 4 ||
-			Rdata->QuadBatchTextureSlotsUsed == c_MaxQuadTexturesPerBatch)
+		//the pointer difference is in vertices, flush if the 4 vertices of this quad don't fit
+		if ((uint32_t)(Rdata->QuadBatchVertexBufferDataPtr - Rdata->QuadBatchVertexBufferDataOrigin) + 4 > Rdata->QuadBatchCapacity * 4 ||
+			Rdata->QuadInstanceBufferDataPtr != Rdata->QuadInstanceBufferDataOrigin)
 			FlushQuadBatch();
+		Rdata->QuadBatchQuadsThisScene++;
 		
-		float textureSlot;
-		if (texture.IsValid() == false)
-			textureSlot = 0.0f;
-		else
-		{
-			bool foundTexture = false;
-			//check if texture is already used
-			for (size_t i = 1; i < Rdata->QuadBatchTextureSlotsUsed; i++)
-			{
-				if (Rdata->QuadBatchTextures[i].GetTextureID() == texture.GetTextureID())
-				{
-					foundTexture = true;
-					textureSlot = i;
-					break;
-				}
-			}
-
-			if (!foundTexture)
-			{
-				Rdata->QuadBatchTextures[Rdata->QuadBatchTextureSlotsUsed] = texture;
-				textureSlot = Rdata->QuadBatchTextureSlotsUsed;
-				Rdata->QuadBatchTextureSlotsUsed++;
-			}
-		}
+		float textureIndex = (float)GetQuadBatchTextureIndex(texture);
 
 		glm::mat4 model = glm::translate(glm::translate(glm::mat4(1.0f), position), glm::vec3(scale));
 		glm::mat4 modelView = Rdata->CurrentSceneDescription.SceneCamera.GetViewMatrix() * model;
@@ -483,59 +607,38 @@ namespace Ainan {
 
 		Rdata->QuadBatchVertexBufferDataPtr->Position = position + (-right - up) / 2.0f;
 		Rdata->QuadBatchVertexBufferDataPtr->Color = color;
-		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
+		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureIndex;
 		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 0.0f, 0.0f };
 		Rdata->QuadBatchVertexBufferDataPtr++;
 
 		Rdata->QuadBatchVertexBufferDataPtr->Position = position + (-right + up) / 2.0f;
 		Rdata->QuadBatchVertexBufferDataPtr->Color = color;
-		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
+		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureIndex;
 		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 0.0f, 1.0f };
 		Rdata->QuadBatchVertexBufferDataPtr++;
 
 		Rdata->QuadBatchVertexBufferDataPtr->Position = position + (right + up) / 2.0f;
 		Rdata->QuadBatchVertexBufferDataPtr->Color = color;
-		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
+		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureIndex;
 		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 1.0f, 1.0f };
 		Rdata->QuadBatchVertexBufferDataPtr++;
 
 		Rdata->QuadBatchVertexBufferDataPtr->Position = position + (+right - up) / 2.0f;
 		Rdata->QuadBatchVertexBufferDataPtr->Color = color;
-		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
+		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureIndex;
 		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 1.0f, 0.0f };
 		Rdata->QuadBatchVertexBufferDataPtr++;
 	}
 
-	void Renderer::DrawQuad(glm::vec2 position, glm::vec4 color, float scale, float rotationInRadians, Texture texture)
+	void Renderer::DrawQuad(glm::vec2 position, glm::vec4 color, float scale, float rotationInRadians, Texture texture, glm::vec2 uvMin, glm::vec2 uvMax)
 	{
-		if ((Rdata->QuadBatchVertexBufferDataPtr - Rdata->QuadBatchVertexBufferDataOrigin) / sizeof(QuadVertex) > 4 ||
-			Rdata->QuadBatchTextureSlotsUsed == c_MaxQuadTexturesPerBatch)
+		//the pointer difference is in vertices, flush if the 4 vertices of this quad don't fit
+		if ((uint32_t)(Rdata->QuadBatchVertexBufferDataPtr - Rdata->QuadBatchVertexBufferDataOrigin) + 4 > Rdata->QuadBatchCapacity * 4 ||
+			Rdata->QuadInstanceBufferDataPtr != Rdata->QuadInstanceBufferDataOrigin)
 			FlushQuadBatch();
+		Rdata->QuadBatchQuadsThisScene++;
 
-		float textureSlot;
-		if (texture.Identifier == std::numeric_limits<uint32_t>::max())
-			textureSlot = 0.0f;
-		else
-		{
-			bool foundTexture = false;
-			//check if texture is already used
-			for (size_t i = 1; i < Rdata->QuadBatchTextureSlotsUsed; i++)
-			{
-				if (Rdata->QuadBatchTextures[i].GetTextureID() == texture.GetTextureID())
-				{
-					foundTexture = true;
-					textureSlot = i;
-					break;
-				}
-			}
-
-			if (!foundTexture)
-			{
-				Rdata->QuadBatchTextures[Rdata->QuadBatchTextureSlotsUsed] = texture;
-				textureSlot = Rdata->QuadBatchTextureSlotsUsed;
-				Rdata->QuadBatchTextureSlotsUsed++;
-			}
-		}
+		float textureIndex = (float)GetQuadBatchTextureIndex(texture);
 
 		float distance = 0.5f * scale;
 		float sine = std::sin(rotationInRadians);
@@ -548,88 +651,208 @@ namespace Ainan {
 
 		Rdata->QuadBatchVertexBufferDataPtr->Position = glm::vec3(position + relPosV0, 0.0f);
 		Rdata->QuadBatchVertexBufferDataPtr->Color = color;
-		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
-		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 0.0f, 0.0f };
+		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureIndex;
+		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = uvMin;
 		Rdata->QuadBatchVertexBufferDataPtr++;
 
 		Rdata->QuadBatchVertexBufferDataPtr->Position = glm::vec3(position + relPosV1, 0.0f);
 		Rdata->QuadBatchVertexBufferDataPtr->Color = color;
-		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
-		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 0.0f, 1.0f };
+		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureIndex;
+		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { uvMin.x, uvMax.y };
 		Rdata->QuadBatchVertexBufferDataPtr++;
 
 		Rdata->QuadBatchVertexBufferDataPtr->Position = glm::vec3(position + relPosV2, 0.0f);
 		Rdata->QuadBatchVertexBufferDataPtr->Color = color;
-		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
-		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 1.0f, 1.0f };
+		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureIndex;
+		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = uvMax;
 		Rdata->QuadBatchVertexBufferDataPtr++;
 
 		Rdata->QuadBatchVertexBufferDataPtr->Position = glm::vec3(position + relPosV3, 0.0f);
 		Rdata->QuadBatchVertexBufferDataPtr->Color = color;
-		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
-		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 1.0f, 0.0f };
+		Rdata->QuadBatchVertexBufferDataPtr->Texture = textureIndex;
+		Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { uvMax.x, uvMin.y };
 		Rdata->QuadBatchVertexBufferDataPtr++;
 	}
 
-	void Renderer::DrawQuadv(glm::vec2* position, glm::vec4* color, float* scale, int count, Texture texture)
+	//packs x and y as two 16 bit unorms, x in the lower bits
+	static uint32_t PackUV(glm::vec2 uv)
 	{
-		if ((Rdata->QuadBatchVertexBufferDataPtr - Rdata->QuadBatchVertexBufferDataOrigin) / sizeof(QuadVertex) > count * 4 ||
-			Rdata->QuadBatchTextureSlotsUsed == c_MaxQuadTexturesPerBatch)
+		glm::vec2 scaled = glm::clamp(uv, 0.0f, 1.0f) * 65535.0f + 0.5f;
+		return (uint32_t)scaled.x | ((uint32_t)scaled.y << 16);
+	}
+
+	void Renderer::DrawQuadv(glm::vec2* position, glm::vec4* color, float* scale, int count, Texture texture, glm::vec2 uvMin, glm::vec2 uvMax)
+	{
+		if (count <= 0)
+			return;
+		Rdata->QuadInstancesThisScene += count;
+
+		//quads from DrawQuad are drawn first so the order of the draws is kept
+		if (Rdata->QuadBatchVertexBufferDataPtr != Rdata->QuadBatchVertexBufferDataOrigin)
 			FlushQuadBatch();
-		
-		assert(count < c_MaxQuadsPerBatch);
 
-		float textureSlot;
-		if (texture.IsValid() == false)
-			textureSlot = 0.0f;
-		else
+		uint32_t textureIndex = GetQuadBatchTextureIndex(texture);
+		uint32_t packedUVMin = PackUV(uvMin);
+		uint32_t packedUVMax = PackUV(uvMax);
+
+		int32_t i = 0;
+		while (i < count)
 		{
-			bool foundTexture = false;
-			//check if texture is already used
-			for (size_t i = 1; i < Rdata->QuadBatchTextureSlotsUsed; i++)
+			int32_t freeInstances = (int32_t)Rdata->QuadBatchCapacity - (int32_t)(Rdata->QuadInstanceBufferDataPtr - Rdata->QuadInstanceBufferDataOrigin);
+			if (freeInstances == 0)
 			{
-				if (Rdata->QuadBatchTextures[i].GetTextureID() == texture.GetTextureID())
-				{
-					foundTexture = true;
-					textureSlot = i;
-					break;
-				}
+				//flushing frees the texture slots, so the texture has to be added again
+				FlushQuadBatch();
+				textureIndex = GetQuadBatchTextureIndex(texture);
+				continue;
 			}
 
-			if (!foundTexture)
+			int32_t end = std::min(count, i + freeInstances);
+			QuadInstance* instance = Rdata->QuadInstanceBufferDataPtr;
+			for (; i < end; i++)
 			{
-				Rdata->QuadBatchTextures[Rdata->QuadBatchTextureSlotsUsed] = texture;
-				textureSlot = Rdata->QuadBatchTextureSlotsUsed;
-				Rdata->QuadBatchTextureSlotsUsed++;
+				glm::vec4 clampedColor = glm::clamp(color[i], 0.0f, 1.0f) * 255.0f + 0.5f;
+
+				instance->Position = position[i];
+				instance->Scale = scale[i];
+				instance->Color = (uint32_t)clampedColor.r | ((uint32_t)clampedColor.g << 8) |
+					((uint32_t)clampedColor.b << 16) | ((uint32_t)clampedColor.a << 24);
+				instance->Texture = textureIndex;
+				instance->UVMin = packedUVMin;
+				instance->UVMax = packedUVMax;
+				instance++;
 			}
+			Rdata->QuadInstanceBufferDataPtr = instance;
+		}
+	}
+
+	uint32_t Renderer::GetQuadBatchTextureIndex(Texture texture)
+	{
+		if (texture.IsValid() == false)
+			texture = Rdata->WhiteTexture;
+
+		QuadTextureLocation location = GetQuadTextureLocation(texture);
+		QuadTextureArray& array = Rdata->QuadTextureArrays[location.Array];
+
+		//bind the array to a slot if it's the first texture from it in this batch
+		if (array.BatchIndex != Rdata->QuadBatchIndex)
+		{
+			if (Rdata->QuadBatchTextureSlotsUsed == c_MaxQuadTexturesPerBatch)
+				FlushQuadBatch();
+
+			array.BatchIndex = Rdata->QuadBatchIndex;
+			array.BatchSlot = Rdata->QuadBatchTextureSlotsUsed;
+			Rdata->QuadBatchTextureArrays[Rdata->QuadBatchTextureSlotsUsed] = location.Array;
+			Rdata->QuadBatchTextureSlotsUsed++;
+		}
+
+		return array.BatchSlot * c_MaxQuadTextureArrayLayers + location.Layer;
+	}
+
+	QuadTextureLocation Renderer::GetQuadTextureLocation(Texture texture)
+	{
+		auto it = Rdata->QuadTextureLocations.find(texture.Identifier);
+		if (it != Rdata->QuadTextureLocations.end())
+			return it->second;
+
+		const TextureDataView& view = Rdata->Textures[texture.Identifier];
+
+		//texture arrays are sampled directly, copying them would keep a second copy of the pixels that has to be
+		//copied again every time they change. quads draw their first layer
+		if (view.Type == TextureType::Texture2DArray)
+		{
+			//reuse the entry of a destroyed array unless the current batch still binds it
+			uint32_t arrayIndex = 0;
+			for (; arrayIndex < Rdata->QuadTextureArrays.size(); arrayIndex++)
+			{
+				QuadTextureArray& array = Rdata->QuadTextureArrays[arrayIndex];
+				if (array.External && !array.Array.IsValid() && array.BatchIndex != Rdata->QuadBatchIndex)
+					break;
+			}
+
+			if (arrayIndex == Rdata->QuadTextureArrays.size())
+				Rdata->QuadTextureArrays.push_back(QuadTextureArray());
+
+			QuadTextureArray& array = Rdata->QuadTextureArrays[arrayIndex];
+			array.Array = texture;
+			array.External = true;
+			array.Size = view.Size;
+			array.Format = view.Format;
+			array.LayerCount = view.Layers;
+			array.NextLayer = view.Layers;
+
+			QuadTextureLocation location = { arrayIndex, 0 };
+			Rdata->QuadTextureLocations[texture.Identifier] = location;
+			return location;
+		}
+
+		//find an array of the same size and format that has room for another layer
+		uint32_t arrayIndex = 0;
+		for (; arrayIndex < Rdata->QuadTextureArrays.size(); arrayIndex++)
+		{
+			const QuadTextureArray& array = Rdata->QuadTextureArrays[arrayIndex];
+			if (!array.External && array.Size == view.Size && array.Format == view.Format &&
+				(array.FreeLayers.size() > 0 || array.NextLayer < c_MaxQuadTextureArrayLayers))
+				break;
+		}
+
+		if (arrayIndex == Rdata->QuadTextureArrays.size())
+		{
+			QuadTextureArray array;
+			array.Size = view.Size;
+			array.Format = view.Format;
+			Rdata->QuadTextureArrays.push_back(array);
 		}
 
-		for (size_t i = 0; i < count; i++)
+		QuadTextureArray& array = Rdata->QuadTextureArrays[arrayIndex];
+		uint32_t layer;
+		if (array.FreeLayers.size() > 0)
 		{
-			Rdata->QuadBatchVertexBufferDataPtr->Position = glm::vec3( position[i], 0.0f);
-			Rdata->QuadBatchVertexBufferDataPtr->Color = color[i];
-			Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
-			Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 0.0f, 0.0f };
-			Rdata->QuadBatchVertexBufferDataPtr++;
-
-			Rdata->QuadBatchVertexBufferDataPtr->Position =  glm::vec3(position[i] + glm::vec2(0.0f, 1.0f) * scale[i], 0.0f);
-			Rdata->QuadBatchVertexBufferDataPtr->Color = color[i];
-			Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
-			Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 0.0f, 1.0f };
-			Rdata->QuadBatchVertexBufferDataPtr++;
-
-			Rdata->QuadBatchVertexBufferDataPtr->Position = glm::vec3(position[i] + glm::vec2(1.0f, 1.0f) * scale[i], 0.0f);
-			Rdata->QuadBatchVertexBufferDataPtr->Color = color[i];
-			Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
-			Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 1.0f, 1.0f };
-			Rdata->QuadBatchVertexBufferDataPtr++;
-
-			Rdata->QuadBatchVertexBufferDataPtr->Position = glm::vec3(position[i] + glm::vec2(1.0f, 0.0f) * scale[i], 0.0f);
-			Rdata->QuadBatchVertexBufferDataPtr->Color = color[i];
-			Rdata->QuadBatchVertexBufferDataPtr->Texture = textureSlot;
-			Rdata->QuadBatchVertexBufferDataPtr->TextureCoordinates = { 1.0f, 0.0f };
-			Rdata->QuadBatchVertexBufferDataPtr++;
+			layer = array.FreeLayers.back();
+			array.FreeLayers.pop_back();
 		}
+		else
+		{
+			if (array.NextLayer == array.LayerCount)
+			{
+				//move the layers to a bigger array, quads already in the batch bind the new array when it's flushed
+				uint32_t layerCount = array.LayerCount == 0 ? c_QuadTextureArrayInitialLayerCount : std::min(array.LayerCount * 2, c_MaxQuadTextureArrayLayers);
+				Texture biggerArray = CreateTextureArray(array.Size, array.Format, layerCount);
+				if (array.LayerCount > 0)
+				{
+					CopyTexture(array.Array, 0, biggerArray, 0, array.NextLayer);
+					DestroyTexture(array.Array);
+				}
+				array.Array = biggerArray;
+				array.LayerCount = layerCount;
+			}
+			layer = array.NextLayer++;
+		}
+
+		CopyTexture(texture, 0, array.Array, layer);
+
+		QuadTextureLocation location = { arrayIndex, layer };
+		Rdata->QuadTextureLocations[texture.Identifier] = location;
+		return location;
+	}
+
+	void Renderer::RemoveQuadTexture(Texture texture)
+	{
+		auto it = Rdata->QuadTextureLocations.find(texture.Identifier);
+		if (it == Rdata->QuadTextureLocations.end())
+			return;
+
+		QuadTextureArray& array = Rdata->QuadTextureArrays[it->second.Array];
+		//quads in the batch that isn't flushed yet may sample the texture, draw them before the array is destroyed
+		//or the layer is given to another texture and overwritten
+		if (array.BatchIndex == Rdata->QuadBatchIndex)
+			FlushQuadBatch();
+
+		if (array.External)
+			array.Array = Texture();
+		else
+			array.FreeLayers.push_back(it->second.Layer);
+		Rdata->QuadTextureLocations.erase(it);
 	}
 
 	void Renderer::ImGuiNewFrame()
@@ -702,6 +925,24 @@ namespace Ainan {
 		Rdata->CurrentActiveAPI->ImGuiEndFrame(redraw);
 	}
 
+	ImDrawData* Renderer::CopyImGuiDrawData(const ImDrawData* drawData)
+	{
+		ImDrawData* copy = new ImDrawData(*drawData);
+		copy->CmdLists = new ImDrawList*[drawData->CmdListsCount];
+		for (int32_t i = 0; i < drawData->CmdListsCount; i++)
+			copy->CmdLists[i] = drawData->CmdLists[i]->CloneOutput();
+
+		return copy;
+	}
+
+	void Renderer::DeleteImGuiDrawData(ImDrawData* drawData)
+	{
+		for (int32_t i = 0; i < drawData->CmdListsCount; i++)
+			IM_DELETE(drawData->CmdLists[i]);
+		delete[] drawData->CmdLists;
+		delete drawData;
+	}
+
 	uint32_t Renderer::GetUsedGPUMemory()
 	{
 		uint32_t memory = 0;
@@ -754,17 +995,23 @@ namespace Ainan {
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::Present;
 		PushCommand(cmd);
+
+		//the renderer thread executes this frame while the next one is recorded
+		Rdata->CommandQueue.Submit();
 		CleanupDeletedObjects();
 
-		LastFrameDeltaTime = glfwGetTime() - LastFrameFinishTime;
-		LastFrameFinishTime = glfwGetTime();
+		LastFrameDeltaTime = Window::GetTime() - LastFrameFinishTime;
+		LastFrameFinishTime = Window::GetTime();
 	}
 
 	void Renderer::SleepExtraFrametime()
 	{
-		LastFrameDeltaTime = glfwGetTime() - LastFrameFinishTime;
+		//submit what was recorded even if nothing is presented so commands don't pile up
+		SubmitCommands();
+
+		LastFrameDeltaTime = Window::GetTime() - LastFrameFinishTime;
 		std::this_thread::sleep_for(std::chrono::duration<double>((1 / 60.0) - LastFrameDeltaTime));
-		LastFrameFinishTime = glfwGetTime();
+		LastFrameFinishTime = Window::GetTime();
 	}
 
 	void Renderer::RecreateSwapchain(const glm::vec2& newSwapchainSize)
@@ -1099,8 +1346,8 @@ namespace Ainan {
 
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::CreateIndexBuffer;
-		IndexBufferCreationInfo* info = new IndexBufferCreationInfo;
-		info->InitialData = new uint8_t[view.Size];
+		IndexBufferCreationInfo* info = Rdata->CommandQueue.AllocatePayload<IndexBufferCreationInfo>();
+		info->InitialData = Rdata->CommandQueue.AllocatePayload<uint8_t>(view.Size);
 		memcpy(info->InitialData, data, view.Size);
 		info->Count = count;
 		cmd.CreateIndexBufferCmdDesc.Info = info;
@@ -1119,7 +1366,7 @@ namespace Ainan {
 		Renderer::PushCommand(cmd);
 	}
 
-	VertexBuffer Renderer::CreateVertexBuffer(void* data, uint32_t size, const VertexLayout& layout, ShaderProgram shaderProgram, bool dynamic)
+	VertexBuffer Renderer::CreateVertexBuffer(void* data, uint32_t size, const VertexLayout& layout, ShaderProgram shaderProgram, bool dynamic, bool perInstance, bool persistentlyMapped)
 	{
 		static uint32_t s_IdentifierCounter = 1;
 		VertexBuffer bufferHandle;
@@ -1130,10 +1377,11 @@ namespace Ainan {
 
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::CreateVertexBuffer;
+		//the layout needs its destructor so the info itself isn't a payload, the backend deletes it
 		VertexBufferCreationInfo* info = new VertexBufferCreationInfo;
 		if (data != nullptr)
 		{
-			info->InitialData = new uint8_t[size];
+			info->InitialData = Rdata->CommandQueue.AllocatePayload<uint8_t>(size);
 			memcpy(info->InitialData, data, size);
 		}
 		else
@@ -1142,6 +1390,8 @@ namespace Ainan {
 		info->Layout = layout;
 		info->Size = size;
 		info->Dynamic = dynamic;
+		info->PerInstance = perInstance;
+		info->PersistentlyMapped = persistentlyMapped;
 		cmd.CreateVertexBufferCmdDesc.Info = info;
 		cmd.CreateVertexBufferCmdDesc.Output = &Rdata->VertexBuffers[s_IdentifierCounter];
 
@@ -1193,7 +1443,7 @@ namespace Ainan {
 
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::CreateFramebuffer;
-		FramebufferCreationInfo* info = new FramebufferCreationInfo;
+		FramebufferCreationInfo* info = Rdata->CommandQueue.AllocatePayload<FramebufferCreationInfo>();
 		info->Size = size;
 		cmd.CreateFramebufferCmdDesc.Info = info;
 		cmd.CreateFramebufferCmdDesc.Output = &Rdata->Framebuffers[s_IdentifierCounter];
@@ -1211,6 +1461,7 @@ namespace Ainan {
 		PushCommand(cmd);
 	}
 
+	//every identifier is given to exactly one CreateTexture command, in order, see RendererData::CreatedTextureCount
 	static uint32_t s_TextureIdentifierCounter = 1;
 	Texture Renderer::CreateTexture(const glm::vec2& size, TextureFormat format, TextureType type, uint8_t* data)
 	{
@@ -1224,15 +1475,16 @@ namespace Ainan {
 
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::CreateTexture;
-		TextureCreationInfo* info = new TextureCreationInfo;
+		TextureCreationInfo* info = Rdata->CommandQueue.AllocatePayload<TextureCreationInfo>();
 		info->Size = size;
 		info->Format = format;
 		info->Type = type;
+		info->Layers = 1;
 		int32_t comp = GetBytesPerPixel(info->Format);
 
 		if (data)
 		{
-			info->InitialData = new uint8_t[size.x * size.y * comp];
+			info->InitialData = Rdata->CommandQueue.AllocatePayload<uint8_t>(size.x * size.y * comp);
 			memcpy(info->InitialData, data, sizeof(uint8_t) * size.x * size.y * comp);
 		}
 		else
@@ -1254,7 +1506,7 @@ namespace Ainan {
 	{
 		int32_t comp = GetBytesPerPixel(faces[0].Format);
 		size_t faceDataSize = faces[0].m_Width * faces[0].m_Height * comp;
-		uint8_t* data = new uint8_t[faceDataSize * faces.size()];
+		uint8_t* data = Rdata->CommandQueue.AllocatePayload<uint8_t>(faceDataSize * faces.size());
 		for (size_t i = 0; i < faces.size(); i++)
 		{
 			if (!faces[i].m_Data)
@@ -1272,12 +1524,40 @@ namespace Ainan {
 
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::CreateTexture;
-		TextureCreationInfo* info = new TextureCreationInfo;
+		TextureCreationInfo* info = Rdata->CommandQueue.AllocatePayload<TextureCreationInfo>();
 		info->Size = view.Size;
 		info->Format = view.Format;
 		info->Type = view.Type;
 		info->InitialData = data;
+		info->Layers = 1;
+
+		cmd.CreateTextureProgramCmdDesc.Info = info;
+		cmd.CreateTextureProgramCmdDesc.Output = &Rdata->Textures[s_TextureIdentifierCounter];
+
+		PushCommand(cmd);
+		s_TextureIdentifierCounter++;
+		return textureHandle;
+	}
+
+	Texture Renderer::CreateTextureArray(const glm::vec2& size, TextureFormat format, uint32_t layers)
+	{
+		Texture textureHandle;
+		textureHandle.Identifier = s_TextureIdentifierCounter;
+		TextureDataView view;
+		view.Format = format;
+		view.Size = size;
+		view.Type = TextureType::Texture2DArray;
+		view.Layers = layers;
+		Rdata->Textures[s_TextureIdentifierCounter] = view;
 
+		RenderCommand cmd;
+		cmd.Type = RenderCommandType::CreateTexture;
+		TextureCreationInfo* info = Rdata->CommandQueue.AllocatePayload<TextureCreationInfo>();
+		info->Size = size;
+		info->Format = format;
+		info->Type = TextureType::Texture2DArray;
+		info->InitialData = nullptr;
+		info->Layers = layers;
 		cmd.CreateTextureProgramCmdDesc.Info = info;
 		cmd.CreateTextureProgramCmdDesc.Output = &Rdata->Textures[s_TextureIdentifierCounter];
 
@@ -1286,8 +1566,32 @@ namespace Ainan {
 		return textureHandle;
 	}
 
+	void Renderer::CopyTexture(Texture source, uint32_t sourceLayer, Texture destination, uint32_t destinationLayer, uint32_t layerCount)
+	{
+		RenderCommand cmd;
+		cmd.Type = RenderCommandType::CopyTexture;
+		cmd.CopyTextureCmdDesc.Source = &Rdata->Textures[source.Identifier];
+		cmd.CopyTextureCmdDesc.SourceLayer = sourceLayer;
+		cmd.CopyTextureCmdDesc.Destination = &Rdata->Textures[destination.Identifier];
+		cmd.CopyTextureCmdDesc.DestinationLayer = destinationLayer;
+		cmd.CopyTextureCmdDesc.LayerCount = layerCount;
+		PushCommand(cmd);
+	}
+
+	void Renderer::ClearTexture(Texture texture)
+	{
+		assert(Rdata->Textures[texture.Identifier].Type == TextureType::Texture2DArray);
+
+		RenderCommand cmd;
+		cmd.Type = RenderCommandType::ClearTexture;
+		cmd.ClearTextureCmdDesc.Texture = &Rdata->Textures[texture.Identifier];
+		PushCommand(cmd);
+	}
+
 	void Renderer::DestroyTexture(Texture tex)
 	{
+		RemoveQuadTexture(tex);
+
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::DestroyTexture;
 		cmd.DestroyTextureCmdDesc.Texture = &Rdata->Textures[tex.Identifier];
@@ -1315,7 +1619,21 @@ namespace Ainan {
 		return programHandle;
 	}
 
-	void Renderer::Draw(VertexBuffer vertexBuffer, ShaderProgram shader, Primitive primitive, IndexBuffer indexBuffer, uint32_t indexCount)
+	void Renderer::DrawInstanced(VertexBuffer vertexBuffer, ShaderProgram shader, Primitive primitive, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstInstance)
+	{
+		RenderCommand cmd;
+		cmd.Type = RenderCommandType::DrawInstanced;
+		cmd.DrawInstancedCmdDesc.VertexBuffer = &Rdata->VertexBuffers[vertexBuffer.Identifier];
+		cmd.DrawInstancedCmdDesc.Shader = &Rdata->ShaderPrograms[shader.Identifier];
+		cmd.DrawInstancedCmdDesc.DrawingPrimitive = primitive;
+		cmd.DrawInstancedCmdDesc.VertexCount = vertexCount;
+		cmd.DrawInstancedCmdDesc.InstanceCount = instanceCount;
+		cmd.DrawInstancedCmdDesc.FirstInstance = firstInstance;
+
+		PushCommand(cmd);
+	}
+
+	void Renderer::Draw(VertexBuffer vertexBuffer, ShaderProgram shader, Primitive primitive, IndexBuffer indexBuffer, uint32_t indexCount, int32_t baseVertex)
 	{
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::DrawIndexedNewWithCustomNumberOfVertices;
@@ -1324,6 +1642,7 @@ namespace Ainan {
 		cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.Shader = &Rdata->ShaderPrograms[shader.Identifier];
 		cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.DrawingPrimitive = primitive;
 		cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.IndexCount = indexCount;
+		cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.BaseVertex = baseVertex;
 
 		Renderer::PushCommand(cmd);
 	}
@@ -1331,24 +1650,215 @@ namespace Ainan {
 	void Renderer::FlushQuadBatch()
 	{
 		for (size_t i = 0; i < Rdata->QuadBatchTextureSlotsUsed; i++)
-			Rdata->ShaderLibrary["QuadBatchShader"].BindTexture(Rdata->QuadBatchTextures[i], i, RenderingStage::FragmentShader);
+			Rdata->ShaderLibrary["QuadBatchShader"].BindTexture(Rdata->QuadTextureArrays[Rdata->QuadBatchTextureArrays[i]].Array, i, RenderingStage::FragmentShader);
 
 		int32_t numVertices = (Rdata->QuadBatchVertexBufferDataPtr - Rdata->QuadBatchVertexBufferDataOrigin);
+		if (numVertices > 0)
+		{
+			uint32_t region = SubmitStreamingRegion(Rdata->QuadBatchVertexBuffer, numVertices * sizeof(QuadVertex));
+
+			Draw(Rdata->QuadBatchVertexBuffer.Buffer, Rdata->ShaderLibrary["QuadBatchShader"], Primitive::Triangles, Rdata->QuadBatchIndexBuffer,
+				(numVertices * 3) / 2, region * Rdata->QuadBatchCapacity * 4);
 
-		Rdata->QuadBatchVertexBuffer.UpdateData(0,
-			numVertices * sizeof(QuadVertex),
-			Rdata->QuadBatchVertexBufferDataOrigin);
+			Rdata->CurrentNumberOfDrawCalls++;
 
-		Draw(Rdata->QuadBatchVertexBuffer, Rdata->ShaderLibrary["QuadBatchShader"], Primitive::Triangles, Rdata->QuadBatchIndexBuffer, (numVertices * 3) / 2);
+			//reset data so we can accept the next batch
+			EndStreamingRegion(Rdata->QuadBatchVertexBuffer);
+			Rdata->QuadBatchVertexBufferDataOrigin = (QuadVertex*)BeginStreamingRegion(Rdata->QuadBatchVertexBuffer);
+			Rdata->QuadBatchVertexBufferDataPtr = Rdata->QuadBatchVertexBufferDataOrigin;
+		}
+
+		FlushQuadInstances();
+
+		//free the texture slots for the next batch, this makes the slots saved in the arrays invalid
+		Rdata->QuadBatchTextureSlotsUsed = 0;
+		Rdata->QuadBatchIndex++;
+	}
+
+	void Renderer::FlushQuadInstances()
+	{
+		uint32_t instanceCount = (uint32_t)(Rdata->QuadInstanceBufferDataPtr - Rdata->QuadInstanceBufferDataOrigin);
+		if (instanceCount == 0)
+			return;
+
+		uint32_t region = SubmitStreamingRegion(Rdata->QuadInstanceVertexBuffer, instanceCount * sizeof(QuadInstance));
+
+		//the vertex shader makes the 6 vertices of the 2 triangles of every quad
+		DrawInstanced(Rdata->QuadInstanceVertexBuffer.Buffer, Rdata->ShaderLibrary["QuadInstanceShader"], Primitive::Triangles, 6,
+			instanceCount, region * Rdata->QuadBatchCapacity);
 
 		Rdata->CurrentNumberOfDrawCalls++;
 
-		//reset data so we can accept the next batch
-		Rdata->QuadBatchVertexBufferDataPtr = Rdata->QuadBatchVertexBufferDataOrigin;
-		Rdata->QuadBatchTextureSlotsUsed = 1;
+		EndStreamingRegion(Rdata->QuadInstanceVertexBuffer);
+		Rdata->QuadInstanceBufferDataOrigin = (QuadInstance*)BeginStreamingRegion(Rdata->QuadInstanceVertexBuffer);
+		Rdata->QuadInstanceBufferDataPtr = Rdata->QuadInstanceBufferDataOrigin;
+	}
+
+	void Renderer::CreateQuadBatchBuffers(uint32_t quadCount)
+	{
+		Rdata->QuadBatchCapacity = quadCount;
+
+		//setup batch renderer
+		{
+			VertexLayout layout(4);
+			layout[0] = VertexLayoutElement("POSITION", 0, ShaderVariableType::Vec3);
+			layout[1] = VertexLayoutElement("NORMAL", 0, ShaderVariableType::Vec4);
+			layout[2] = VertexLayoutElement("TEXCOORD", 0, ShaderVariableType::Float);
+			layout[3] = VertexLayoutElement("TEXCOORD", 1, ShaderVariableType::Vec2);
+
+			CreateStreamingVertexBuffer(Rdata->QuadBatchVertexBuffer, quadCount * 4 * sizeof(QuadVertex), layout, Rdata->ShaderLibrary["QuadBatchShader"], false);
+
+			Rdata->QuadBatchVertexBufferDataOrigin = (QuadVertex*)BeginStreamingRegion(Rdata->QuadBatchVertexBuffer);
+			Rdata->QuadBatchVertexBufferDataPtr = Rdata->QuadBatchVertexBufferDataOrigin;
+		}
+
+		//setup instanced quads
+		{
+			VertexLayout layout(6);
+			layout[0] = VertexLayoutElement("POSITION", 0, ShaderVariableType::Vec2);
+			layout[1] = VertexLayoutElement("NORMAL", 0, ShaderVariableType::Float);
+			layout[2] = VertexLayoutElement("TEXCOORD", 0, ShaderVariableType::UnsignedInt);
+			layout[3] = VertexLayoutElement("TEXCOORD", 1, ShaderVariableType::UnsignedInt);
+			layout[4] = VertexLayoutElement("TEXCOORD", 2, ShaderVariableType::UnsignedInt);
+			layout[5] = VertexLayoutElement("TEXCOORD", 3, ShaderVariableType::UnsignedInt);
+
+			CreateStreamingVertexBuffer(Rdata->QuadInstanceVertexBuffer, quadCount * sizeof(QuadInstance), layout, Rdata->ShaderLibrary["QuadInstanceShader"], true);
+
+			Rdata->QuadInstanceBufferDataOrigin = (QuadInstance*)BeginStreamingRegion(Rdata->QuadInstanceVertexBuffer);
+			Rdata->QuadInstanceBufferDataPtr = Rdata->QuadInstanceBufferDataOrigin;
+		}
+
+		const uint32_t indexCount = quadCount * 6;
+		uint32_t* indicies = new uint32_t[indexCount];
+		uint32_t u = 0;
+		for (uint32_t i = 0; i < indexCount; i += 6)
+		{
+			indicies[i + 0] = 0 + u;
+			indicies[i + 1] = 1 + u;
+			indicies[i + 2] = 2 + u;
+
+			indicies[i + 3] = 0 + u;
+			indicies[i + 4] = 2 + u;
+			indicies[i + 5] = 3 + u;
+			u += 4;
+		}
+
+		Rdata->QuadBatchIndexBuffer = CreateIndexBuffer(indicies, indexCount);
+		delete[] indicies;
+	}
+
+	void Renderer::DestroyQuadBatchBuffers()
+	{
+		DestroyStreamingVertexBuffer(Rdata->QuadBatchVertexBuffer);
+		DestroyStreamingVertexBuffer(Rdata->QuadInstanceVertexBuffer);
+		DestroyIndexBuffer(Rdata->QuadBatchIndexBuffer);
+		Rdata->QuadBatchVertexBufferDataOrigin = nullptr;
+		Rdata->QuadBatchVertexBufferDataPtr = nullptr;
+		Rdata->QuadInstanceBufferDataOrigin = nullptr;
+		Rdata->QuadInstanceBufferDataPtr = nullptr;
+	}
+
+	void Renderer::SetQuadBatchCapacity(uint32_t quadCount)
+	{
+		quadCount = std::clamp(quadCount, 1u, c_MaxQuadBatchCapacity);
+		if (quadCount == Rdata->QuadBatchCapacity)
+			return;
+
+		if (Rdata->QuadBatchVertexBufferDataPtr != Rdata->QuadBatchVertexBufferDataOrigin ||
+			Rdata->QuadInstanceBufferDataPtr != Rdata->QuadInstanceBufferDataOrigin)
+			FlushQuadBatch();
+
+		DestroyQuadBatchBuffers();
+		CreateQuadBatchBuffers(quadCount);
+	}
+
+	void Renderer::CreateStreamingVertexBuffer(StreamingVertexBuffer& buffer, uint32_t regionSize, const VertexLayout& layout, ShaderProgram shaderProgram, bool perInstance)
+	{
+		buffer.Buffer = CreateVertexBuffer(nullptr, regionSize * c_StreamingBufferRegionCount, layout, shaderProgram, true, perInstance, true);
+		buffer.RegionSize = regionSize;
+		buffer.CurrentRegion = 0;
+
+		//the mapping is made by the renderer thread
+		WaitUntilRendererIdle();
+		buffer.MappedData = Rdata->VertexBuffers[buffer.Buffer.Identifier].MappedData;
+		if (!buffer.MappedData)
+			buffer.CPUData = new uint8_t[regionSize];
+	}
+
+	void Renderer::DestroyStreamingVertexBuffer(StreamingVertexBuffer& buffer)
+	{
+		//wait for the draws that are still reading the buffer, this also frees the fences
+		for (auto& fence : buffer.RegionFences)
+		{
+			if (fence.Signaled.load(std::memory_order_acquire))
+				continue;
+
+			RenderCommand cmd;
+			cmd.Type = RenderCommandType::WaitFence;
+			cmd.WaitFenceCmdDesc.Fence = &fence;
+			PushCommand(cmd);
+		}
+
+		DestroyVertexBuffer(buffer.Buffer);
+		delete[] buffer.CPUData;
+		buffer.CPUData = nullptr;
+		buffer.MappedData = nullptr;
+	}
+
+	uint8_t* Renderer::BeginStreamingRegion(StreamingVertexBuffer& buffer)
+	{
+		if (!buffer.MappedData)
+			return buffer.CPUData;
+
+		//the renderer thread checks the fences after every submission, so this is usually already set
+		FenceDataView& fence = buffer.RegionFences[buffer.CurrentRegion];
+		if (!fence.Signaled.load(std::memory_order_acquire))
+		{
+			//the gpu may still be drawing from this region, wait for that draw only.
+			//the fence can be in the commands that aren't submitted yet, submitting only waits if the renderer thread
+			//is still executing the previous submission, and the fence can't be passed before that anyway
+			RenderCommand cmd;
+			cmd.Type = RenderCommandType::WaitFence;
+			cmd.WaitFenceCmdDesc.Fence = &fence;
+			PushCommand(cmd);
+			SubmitCommands();
+
+			while (!fence.Signaled.load(std::memory_order_acquire))
+				std::this_thread::yield();
+		}
+
+		return buffer.MappedData + buffer.CurrentRegion * buffer.RegionSize;
+	}
+
+	uint32_t Renderer::SubmitStreamingRegion(StreamingVertexBuffer& buffer, uint32_t size)
+	{
+		//the data is already in the buffer
+		if (buffer.MappedData)
+			return buffer.CurrentRegion;
+
+		//the draws of the other regions may not have happened yet so they aren't overwritten, the first region after
+		//wrapping around discards the whole buffer instead, the api gives a new buffer if the gpu still reads the old one
+		buffer.Buffer.UpdateData(buffer.CurrentRegion * buffer.RegionSize, size, buffer.CPUData, buffer.CurrentRegion != 0);
+		return buffer.CurrentRegion;
+	}
+
+	void Renderer::EndStreamingRegion(StreamingVertexBuffer& buffer)
+	{
+		if (!buffer.MappedData)
+		{
+			buffer.CurrentRegion = (buffer.CurrentRegion + 1) % c_StreamingBufferRegionCount;
+			return;
+		}
+
+		FenceDataView& fence = buffer.RegionFences[buffer.CurrentRegion];
+		fence.Signaled.store(false, std::memory_order_relaxed);
+
+		RenderCommand cmd;
+		cmd.Type = RenderCommandType::InsertFence;
+		cmd.InsertFenceCmdDesc.Fence = &fence;
+		PushCommand(cmd);
 
-		for (size_t i = 1; i < c_MaxQuadTexturesPerBatch; i++)
-			Rdata->QuadBatchTextures[i].Identifier = std::numeric_limits<uint32_t>::max();
+		buffer.CurrentRegion = (buffer.CurrentRegion + 1) % c_StreamingBufferRegionCount;
 	}
 
 	std::string RendererTypeStr(RendererType type)
@@ -8,6 +8,7 @@
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
 #include "Framebuffer.h"
 #include "Rectangle.h"
 #include "UniformBuffer.h"
@@ -25,9 +26,19 @@ namespace Ainan {
 	const int32_t c_MaxSpotLightCount = 10;
 
 	//batch renderer constants
-	const int32_t c_MaxQuadsPerBatch = 5000;
-	const int32_t c_MaxQuadVerticesPerBatch = c_MaxQuadsPerBatch * 4;
+	//the number of quads a batch can hold, it grows at the start of a scene when a scene draws more quads than this.
+	//it's the number of quads drawn with DrawQuad or the number drawn with DrawQuadv, whichever is bigger
+	const uint32_t c_InitialQuadBatchCapacity = 5000;
+	//the batch doesn't grow past this, the streaming buffers use 3 * 160 bytes per quad
+	const uint32_t c_MaxQuadBatchCapacity = 50000;
 	const int32_t c_MaxQuadTexturesPerBatch = 16;
+	//quad textures are copied into layers of texture arrays, arrays start with one layer and double in size when full.
+	//one layer because a texture is often the only one of its size. texture arrays (like atlas pages) are sampled directly
+	const uint32_t c_QuadTextureArrayInitialLayerCount = 1;
+	//this is also the value the quad shaders use to split the texture index into an array slot and a layer
+	const uint32_t c_MaxQuadTextureArrayLayers = 256;
+	//the main thread fills one region of a streaming vertex buffer while the gpu can still be reading the others
+	const int32_t c_StreamingBufferRegionCount = 3;
 
 	//used internally for batch rendering
 	struct QuadVertex 
@@ -38,6 +49,80 @@ namespace Ainan {
 		glm::vec2 TextureCoordinates;
 	};
 
+	//used internally for instanced quad rendering, the vertex shader expands every instance into a quad.
+	//this is 28 bytes per quad instead of the 4 QuadVertex structs (160 bytes) of the quad batch
+	struct QuadInstance
+	{
+		glm::vec2 Position; //bottom left corner
+		float Scale;
+		uint32_t Color; //RGBA8, red in the lowest byte
+		uint32_t Texture;
+		//texture coordinates of the bottom left and top right corners, two 16 bit unorms each, x in the lower bits
+		uint32_t UVMin;
+		uint32_t UVMax;
+	};
+	static_assert(sizeof(QuadInstance) == 28, "the instance vertex layout and the shaders expect 28 byte instances");
+
+	//used internally to send vertices that change every batch to the gpu.
+	//the buffer is split into c_StreamingBufferRegionCount regions and is persistently mapped, so vertices are written
+	//straight into memory the gpu reads from. a fence after the draw that reads a region tells when it can be reused.
+	//if the api can't map buffers persistently (D3D11) the vertices are written to CPUData and uploaded to the region
+	//with UpdateData without overwriting the other regions, which is a dynamic buffer ring that needs no fences
+	struct StreamingVertexBuffer
+	{
+		VertexBuffer Buffer;
+		uint32_t RegionSize = 0; //in bytes
+		uint32_t CurrentRegion = 0;
+		uint8_t* MappedData = nullptr;
+		uint8_t* CPUData = nullptr;
+		std::array<FenceDataView, c_StreamingBufferRegionCount> RegionFences;
+	};
+
+	//used internally, a texture array that holds copies of the textures drawn with DrawQuad that have its size and format.
+	//a texture array drawn with DrawQuad isn't copied, it gets a QuadTextureArray of its own with External set
+	struct QuadTextureArray
+	{
+		Texture Array;
+		//Array is the texture that was drawn, it's destroyed by its owner and nothing else is copied into it.
+		//Array is invalid once it's destroyed, then the entry can be reused by another external array
+		bool External = false;
+		glm::vec2 Size;
+		TextureFormat Format;
+		uint32_t LayerCount = 0;
+		//layers below this have been handed out, the ones in FreeLayers were given back and can be reused
+		uint32_t NextLayer = 0;
+		std::vector<uint32_t> FreeLayers;
+		//the slot the array is bound to in the quad batch, only valid if BatchIndex is the index of the current batch
+		uint64_t BatchIndex = std::numeric_limits<uint64_t>::max();
+		uint32_t BatchSlot = 0;
+	};
+
+	//where the copy of a texture is in the quad texture arrays
+	struct QuadTextureLocation
+	{
+		uint32_t Array;
+		uint32_t Layer;
+	};
+
+	//the state a draw uses, draws submitted with SubmitDrawPacket are sorted by it so that draws that use the same
+	//shader and texture are next to each other, see MakeDrawKey in the cpp file for how the fields are packed
+	struct DrawKey
+	{
+		//blended draws show what was drawn before them, so they are drawn in the order they were submitted
+		//(the order of the environment objects) and are only grouped by shader and texture with draws next to them
+		bool Blended = false;
+		uint32_t Shader = 0; //ShaderProgram::Identifier
+		uint32_t Texture = 0; //Texture::Identifier of the texture that is bound or batched, 0 if there is none
+		float Depth = 0.0f; //only orders draws with the same state, smaller depth first
+	};
+
+	//used internally, a draw that waits in the current scene until it's sorted
+	struct DrawPacket
+	{
+		uint64_t Key;
+		std::function<void()> Draw;
+	};
+
 	struct SceneDescription
 	{
 		Camera SceneCamera;										   //Required
@@ -56,28 +141,54 @@ namespace Ainan {
 		//this terminates the renderer and stops the rendering thread
 		static void Terminate();
 
-		//This will be changed to only render in end scene by putting draw commands to a command buffer 
+		//draws between BeginScene and EndScene are recorded into the frame's command buffer, draw packets are sorted and
+		//recorded in EndScene. the renderer thread executes the frame after it's submitted by Present
 		static void BeginScene(const SceneDescription& desc);
 		static void AddRadialLight(const glm::vec2& pos, const glm::vec4& color, float intensity);
 		static void AddSpotLight(const glm::vec2& pos, const glm::vec4 color, float angle, float innerCutoff, float outerCutoff, float intensity);
+		//draw is called in EndScene after the packets of the scene are sorted by their keys, it should make the draw calls the key
+		//describes. packets with the same key are drawn in the order they are submitted
+		static void SubmitDrawPacket(const DrawKey& key, std::function<void()> draw);
 		static void EndScene();
 		
 		static void WaitUntilRendererIdle();
+		//sends what was recorded to the renderer thread without presenting, only waits if the renderer thread
+		//is still executing the commands submitted before
+		static void SubmitCommands();
 
 		//position is in world coordinates
 		static void DrawQuad(glm::vec3 position, glm::vec4 color, float scale, Texture texture);
-		static void DrawQuad(glm::vec2 position, glm::vec4 color, float scale, float rotationInRadians, Texture texture);
-		static void DrawQuadv(glm::vec2* position, glm::vec4* color, float* scale, int32_t count, Texture texture);
+		//uvMin and uvMax are the texture coordinates of the bottom left and top right corners
+		static void DrawQuad(glm::vec2 position, glm::vec4 color, float scale, float rotationInRadians, Texture texture,
+			glm::vec2 uvMin = { 0.0f, 0.0f }, glm::vec2 uvMax = { 1.0f, 1.0f });
+		static void DrawQuad(glm::vec2 position, glm::vec4 color, float scale, float rotationInRadians, AtlasRegion region)
+		{
+			DrawQuad(position, color, scale, rotationInRadians, region.Page, region.UVMin, region.UVMax);
+		}
+		static void DrawQuadv(glm::vec2* position, glm::vec4* color, float* scale, int32_t count, Texture texture,
+			glm::vec2 uvMin = { 0.0f, 0.0f }, glm::vec2 uvMax = { 1.0f, 1.0f });
+		static void DrawQuadv(glm::vec2* position, glm::vec4* color, float* scale, int32_t count, AtlasRegion region)
+		{
+			DrawQuadv(position, color, scale, count, region.Page, region.UVMin, region.UVMax);
+		}
 
 		static void Draw(VertexBuffer vertexBuffer, ShaderProgram shader, Primitive primitive, int32_t vertexCount);
 
-		static void Draw(VertexBuffer vertexBuffer, ShaderProgram shader, Primitive primitive, IndexBuffer indexBuffer, uint32_t indexCount);
+		//baseVertex is added to every index read from indexBuffer
+		static void Draw(VertexBuffer vertexBuffer, ShaderProgram shader, Primitive primitive, IndexBuffer indexBuffer, uint32_t indexCount, int32_t baseVertex = 0);
 
 		static void Draw(VertexBuffer vertexBuffer, ShaderProgram shader, Primitive primitive, IndexBuffer indexBuffer);
 
+		//draws instanceCount instances of vertexCount vertices each, vertexBuffer should be created with perInstance set to true
+		static void DrawInstanced(VertexBuffer vertexBuffer, ShaderProgram shader, Primitive primitive, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstInstance = 0);
+
 		static void ImGuiNewFrame();
 		static void RegisterWindowThatCanCoverViewport();
 		static void ImGuiEndFrame(bool redraw);
+		//copies the draw data and its draw lists so the renderer thread can draw it while ImGui records the next frame.
+		//free the copy with DeleteImGuiDrawData once it's drawn
+		static ImDrawData* CopyImGuiDrawData(const ImDrawData* drawData);
+		static void DeleteImGuiDrawData(ImDrawData* drawData);
 
 		static uint32_t GetUsedGPUMemory();
 
@@ -99,7 +210,7 @@ namespace Ainan {
 
 		static VertexBuffer CreateVertexBuffer(void* data, uint32_t size,
 			const VertexLayout& layout, ShaderProgram shaderProgram,
-			bool dynamic = false);
+			bool dynamic = false, bool perInstance = false, bool persistentlyMapped = false);
 		static void DestroyVertexBuffer(VertexBuffer vb);
 
 		//data should ALWAYS a uint32_t array
@@ -121,10 +232,28 @@ namespace Ainan {
 		//creates a 2D texture with the image format and size
 		static Texture CreateTexture(Image& img);
 		static Texture CreateCubemapTexture(std::array<Image, 6>& faces);
+		//creates an array of layers empty 2D textures, fill them with CopyTexture or ClearTexture
+		static Texture CreateTextureArray(const glm::vec2& size, TextureFormat format, uint32_t layers);
+
+		//copies layerCount layers between textures of the same size and format, 2D textures only have layer 0
+		static void CopyTexture(Texture source, uint32_t sourceLayer, Texture destination, uint32_t destinationLayer, uint32_t layerCount = 1);
+		//sets every pixel of a texture array to zero on the gpu
+		static void ClearTexture(Texture texture);
 		
 		static void DestroyTexture(Texture tex);
 
+		//packs a small RGBA image into the texture atlas so that it can be batched with other images, see TextureAtlas.
+		//returns an invalid region if the image can't be in the atlas, then it should get its own texture
+		static AtlasRegion AddToTextureAtlas(const std::string& name, const Image& image) { return Rdata->Atlas.Add(name, image); }
+		//call when an image added with AddToTextureAtlas isn't drawn anymore, like when an object changes its image
+		static void RemoveFromTextureAtlas(const std::string& name) { Rdata->Atlas.Remove(name); }
+
+		//call when the data of a texture changes or it's destroyed so that quads don't draw an old copy of it
+		static void RemoveQuadTexture(Texture texture);
+
 		static void FlushQuadBatch();
+		//recreates the quad batch buffers to hold quadCount quads, this flushes the batch and waits for the renderer thread
+		static void SetQuadBatchCapacity(uint32_t quadCount);
 		struct RendererData
 		{
 			RendererType API;
@@ -133,6 +262,9 @@ namespace Ainan {
 			std::thread Thread;
 			bool DestroyThread = false;
 			RenderCommandQueue CommandQueue;
+			//textures are created in the order of their identifiers (starting at 1), the renderer thread increments this
+			//after creating one, so the api identifiers in Textures[id] can be read once this is at least id
+			std::atomic<uint32_t> CreatedTextureCount = 0;
 
 			//GPU objects
 			std::unordered_map<uint32_t, VertexBufferDataView> VertexBuffers;
@@ -176,14 +308,39 @@ namespace Ainan {
 			int32_t SpotLightSubmissionCount = 0;
 
 			//batch renderer data
-			VertexBuffer QuadBatchVertexBuffer;
+			uint32_t QuadBatchCapacity = 0; //in quads
+			//quads drawn in the current scene and the most quads drawn in a scene, used to size the batch
+			uint32_t QuadBatchQuadsThisScene = 0;
+			uint32_t QuadInstancesThisScene = 0;
+			uint32_t PeakQuadsPerScene = 0;
+			StreamingVertexBuffer QuadBatchVertexBuffer;
 			IndexBuffer QuadBatchIndexBuffer;
 			QuadVertex* QuadBatchVertexBufferDataOrigin = nullptr;
 			QuadVertex* QuadBatchVertexBufferDataPtr = nullptr;
-			//first one is reserved for blank white texture, so we have c_MaxQuadTexturesPerBatch - 1 textures in total
+			//drawn when a quad has no texture
 			Texture WhiteTexture;
-			std::array<Texture, c_MaxQuadTexturesPerBatch> QuadBatchTextures;
+			//quads sample their textures from copies in texture arrays, a batch can bind c_MaxQuadTexturesPerBatch arrays.
+			//so a batch can have any number of textures as long as they only have a few different sizes
+			std::vector<QuadTextureArray> QuadTextureArrays;
+			std::unordered_map<uint32_t, QuadTextureLocation> QuadTextureLocations; //key is Texture::Identifier
+			std::array<uint32_t, c_MaxQuadTexturesPerBatch> QuadBatchTextureArrays; //index in QuadTextureArrays of every slot
 			uint32_t QuadBatchTextureSlotsUsed = 0;
+			uint64_t QuadBatchIndex = 0;
+			//small images drawn as quads are packed here so they share a texture
+			TextureAtlas Atlas;
+			//instanced quads share the textures above, only one of the two kinds of quads is batched at a time
+			StreamingVertexBuffer QuadInstanceVertexBuffer;
+			QuadInstance* QuadInstanceBufferDataOrigin = nullptr;
+			QuadInstance* QuadInstanceBufferDataPtr = nullptr;
+
+			//draw packets of the current scene and the buffer they are sorted with, both keep their memory between scenes
+			std::vector<DrawPacket> DrawPackets;
+			std::vector<std::pair<uint64_t, uint32_t>> DrawPacketOrder; //key and index in DrawPackets
+			std::vector<std::pair<uint64_t, uint32_t>> DrawPacketSortBuffer;
+			//identifiers keep growing while the editor runs so they don't fit in the key, the shaders and textures
+			//get indices in the order they are first used in the scene instead, keyed by their identifiers
+			std::unordered_map<uint32_t, uint32_t> DrawKeyShaderIndices;
+			std::unordered_map<uint32_t, uint32_t> DrawKeyTextureIndices;
 
 			//Postprocessing data
 			Framebuffer BlurFramebuffer;
@@ -193,6 +350,11 @@ namespace Ainan {
 			//profiling data
 			uint32_t NumberOfDrawCallsLastScene = 0;
 			uint32_t CurrentNumberOfDrawCalls = 0;
+			//compared to drawing the packets of the last scene in the order they were submitted, these can be negative
+			//because sorting groups shaders first even when another order would switch textures less
+			uint32_t NumberOfDrawPacketsLastScene = 0;
+			int32_t StateChangesSavedLastScene = 0;
+			int32_t DrawCallsSavedLastScene = 0;
 			double Time = 0.0;
 		};
 
@@ -208,6 +370,23 @@ namespace Ainan {
 		static void DrawImGui(ImDrawData* drawData);
 		static void Blur(Framebuffer target, float radius);
 		static void CleanupDeletedObjects();
+		//returns the index the quad shaders sample the texture with, this flushes the batch if all the slots are used
+		static uint32_t GetQuadBatchTextureIndex(Texture texture);
+		//copies the texture to a quad texture array if it isn't in one already
+		static QuadTextureLocation GetQuadTextureLocation(Texture texture);
+		static void CreateStreamingVertexBuffer(StreamingVertexBuffer& buffer, uint32_t regionSize, const VertexLayout& layout, ShaderProgram shaderProgram, bool perInstance);
+		static void DestroyStreamingVertexBuffer(StreamingVertexBuffer& buffer);
+		//waits until the gpu is done with the current region and returns where to write to it
+		static uint8_t* BeginStreamingRegion(StreamingVertexBuffer& buffer);
+		//makes the first size bytes of the current region visible to the gpu and returns the index of the region to draw from
+		static uint32_t SubmitStreamingRegion(StreamingVertexBuffer& buffer, uint32_t size);
+		//call after pushing the draws that read the current region, this fences it and moves to the next region
+		static void EndStreamingRegion(StreamingVertexBuffer& buffer);
+		static void FlushQuadInstances();
+		static void CreateQuadBatchBuffers(uint32_t quadCount);
+		static void DestroyQuadBatchBuffers();
+		//sorts the packets of the scene, draws them and updates the sorting stats
+		static void DrawSortedPackets();
 	};
 
 	struct ImGuiViewportDataGlfw
@@ -21,6 +21,8 @@ namespace Ainan {
 		virtual void ImGuiEndFrame(bool redraw) = 0;
 		virtual void DrawImGui(ImDrawData* drawData) = 0;
 		virtual void ExecuteCommand(RenderCommand cmd) = 0;
+		//checks the fences inserted with InsertFence without blocking and sets Signaled on the ones the gpu has passed
+		virtual void PollFences() = 0;
 		virtual void SetBlendMode(RenderingBlendMode blendMode) = 0;
 		virtual RendererContext* GetContext() = 0;
 	};
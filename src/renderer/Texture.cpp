@@ -6,6 +6,9 @@ namespace Ainan
 {
 	void Texture::UpdateData(std::shared_ptr<Image> image)
 	{
+		//quads have to copy the new data
+		Renderer::RemoveQuadTexture(*this);
+
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::UpdateTexture;
 		cmd.UpdateTextureCmdDesc.Texture = &Renderer::Rdata->Textures[Identifier];
@@ -33,7 +36,7 @@ namespace Ainan
 		default:
 			break;
 		}
-		cmd.UpdateTextureCmdDesc.Data = new uint8_t[image->m_Width * image->m_Height * comp];
+		cmd.UpdateTextureCmdDesc.Data = Renderer::Rdata->CommandQueue.AllocatePayload<uint8_t>(image->m_Width * image->m_Height * comp);
 		memcpy(cmd.UpdateTextureCmdDesc.Data, image->m_Data, sizeof(uint8_t) * image->m_Width * image->m_Height * comp);
 
 		Renderer::PushCommand(cmd);
@@ -50,7 +53,7 @@ namespace Ainan
 		cmd.UpdateTextureCmdDesc.Height = images[0].m_Height;
 		cmd.UpdateTextureCmdDesc.Format = images[0].Format;
 		int32_t bpp = GetBytesPerPixel(images[0].Format);
-		cmd.UpdateTextureCmdDesc.Data = new uint8_t[images[0].m_Width * images[0].m_Height * bpp * images.size()];
+		cmd.UpdateTextureCmdDesc.Data = Renderer::Rdata->CommandQueue.AllocatePayload<uint8_t>(images[0].m_Width * images[0].m_Height * bpp * images.size());
 		for (size_t i = 0; i < images.size(); i++)
 			memcpy((uint8_t*)cmd.UpdateTextureCmdDesc.Data + i * images[0].m_Width * images[0].m_Height * bpp, images[i].m_Data,
 				sizeof(uint8_t) * images[0].m_Width * images[0].m_Height * bpp);
@@ -58,10 +61,40 @@ namespace Ainan
 		Renderer::PushCommand(cmd);
 	}
 
+	void Texture::UpdateRegion(const Image& image, int32_t x, int32_t y)
+	{
+		const TextureDataView& view = Renderer::Rdata->Textures[Identifier];
+		assert(view.Type == TextureType::Texture2D || (view.Type == TextureType::Texture2DArray && view.Layers == 1));
+		assert(view.Format == image.Format);
+
+		//quads have to copy the new data, texture arrays are sampled directly so they have no copy
+		if (view.Type == TextureType::Texture2D)
+			Renderer::RemoveQuadTexture(*this);
+
+		RenderCommand cmd;
+		cmd.Type = RenderCommandType::UpdateTextureRegion;
+		cmd.UpdateTextureRegionCmdDesc.Texture = &Renderer::Rdata->Textures[Identifier];
+		cmd.UpdateTextureRegionCmdDesc.X = x;
+		cmd.UpdateTextureRegionCmdDesc.Y = y;
+		cmd.UpdateTextureRegionCmdDesc.Width = image.m_Width;
+		cmd.UpdateTextureRegionCmdDesc.Height = image.m_Height;
+		size_t size = image.m_Width * image.m_Height * GetBytesPerPixel(image.Format);
+		cmd.UpdateTextureRegionCmdDesc.Data = Renderer::Rdata->CommandQueue.AllocatePayload<uint8_t>(size);
+		memcpy(cmd.UpdateTextureRegionCmdDesc.Data, image.m_Data, size);
+
+		Renderer::PushCommand(cmd);
+	}
+
 	uint64_t Texture::GetTextureID()
 	{
+		//the api identifiers are written by the renderer thread, a texture created this frame might not exist yet
+		if (Renderer::Rdata->CreatedTextureCount.load(std::memory_order_acquire) < Identifier)
+			Renderer::WaitUntilRendererIdle();
+
 		auto& data = Renderer::Rdata->Textures[Identifier];
-		if (data.Sampler == std::numeric_limits<uint64_t>::max())
+		if (data.Type == TextureType::Texture2DArray)
+			return data.LayerView;
+		else if (data.Sampler == std::numeric_limits<uint64_t>::max())
 			return Renderer::Rdata->Textures[Identifier].Identifier;
 		else
 			return data.View;
@@ -10,7 +10,9 @@ namespace Ainan {
 	{
 		Unspecified,
 		Texture2D,
-		Cubemap
+		Cubemap,
+		//2D textures of the same size and format, shaders sample them with a layer index
+		Texture2DArray
 	};
 
 	class Texture
@@ -25,6 +27,9 @@ namespace Ainan {
 
 		void UpdateData(std::shared_ptr<Image> image);
 		void UpdateData(std::array<Image, 6> images); //used in cubemaps
+		//replaces the pixels from (x, y) to (x + image width, y + image height), the image has to be in the format of the texture.
+		//works on 2D textures and texture arrays with one layer
+		void UpdateRegion(const Image& image, int32_t x, int32_t y);
 
 		//used by ImGui
 		uint64_t GetTextureID();
@@ -38,6 +43,9 @@ namespace Ainan {
 		TextureType Type;
 		glm::vec2 Size;
 		TextureFormat Format;
+		uint32_t Layers = 1; //only used in texture arrays
+		//a 2D view of a texture array with one layer, ImGui can only draw 2D textures
+		uint64_t LayerView = std::numeric_limits<uint64_t>::max();
 		bool Deleted = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "TextureAtlas.h"
+
+#include "Renderer.h"
+
+namespace Ainan {
+
+	AtlasRegion TextureAtlas::Add(const std::string& name, const Image& image)
+	{
+		auto it = m_Regions.find(name);
+		if (it != m_Regions.end())
+		{
+			it->second.UserCount++;
+			return it->second.Region;
+		}
+
+		if (image.Format != TextureFormat::RGBA || image.m_Width > c_MaxImageSize || image.m_Height > c_MaxImageSize)
+			return AtlasRegion();
+
+		int32_t paddedWidth = image.m_Width + c_Padding * 2;
+		int32_t paddedHeight = image.m_Height + c_Padding * 2;
+
+		//try the pages from the newest because the older ones are more likely to be full
+		int32_t x = 0;
+		int32_t y = 0;
+		Page* page = nullptr;
+		for (auto pageIt = m_Pages.rbegin(); pageIt != m_Pages.rend(); pageIt++)
+		{
+			if (Pack(*pageIt, paddedWidth, paddedHeight, x, y))
+			{
+				page = &*pageIt;
+				break;
+			}
+		}
+
+		if (!page)
+		{
+			Page newPage;
+			//a texture array with one layer so that quads sample the page directly instead of a copy of it.
+			//it's cleared on the gpu to transparent pixels so that the padding around the images is empty
+			newPage.PageTexture = Renderer::CreateTextureArray(glm::vec2(c_PageSize, c_PageSize), TextureFormat::RGBA, 1);
+			Renderer::ClearTexture(newPage.PageTexture);
+			newPage.Skyline.push_back({ 0, 0, c_PageSize });
+			m_Pages.push_back(newPage);
+
+			page = &m_Pages.back();
+			bool packed = Pack(*page, paddedWidth, paddedHeight, x, y);
+			assert(packed);
+		}
+
+		x += c_Padding;
+		y += c_Padding;
+		page->PageTexture.UpdateRegion(image, x, y);
+
+		//the UVs are at the centers of the edge pixels so that filtering doesn't read the padding
+		AtlasRegion region;
+		region.Page = page->PageTexture;
+		region.UVMin = (glm::vec2(x, y) + 0.5f) / (float)c_PageSize;
+		region.UVMax = (glm::vec2(x + image.m_Width, y + image.m_Height) - 0.5f) / (float)c_PageSize;
+		m_Regions[name] = { region, 1 };
+
+		return region;
+	}
+
+	void TextureAtlas::Remove(const std::string& name)
+	{
+		auto it = m_Regions.find(name);
+		if (it == m_Regions.end())
+			return;
+
+		it->second.UserCount--;
+		if (it->second.UserCount == 0)
+			m_Regions.erase(it);
+	}
+
+	AtlasRegion TextureAtlas::Find(const std::string& name) const
+	{
+		auto it = m_Regions.find(name);
+		if (it == m_Regions.end())
+			return AtlasRegion();
+
+		return it->second.Region;
+	}
+
+	std::string TextureAtlas::GetImageName(const std::filesystem::path& path)
+	{
+		//a file that can't be read has no time, the image loaded from it is empty and isn't added anyway
+		std::error_code error;
+		auto writeTime = std::filesystem::last_write_time(path, error);
+		int64_t time = error ? 0 : (int64_t)writeTime.time_since_epoch().count();
+
+		return path.lexically_normal().u8string() + "|" + std::to_string(time);
+	}
+
+	void TextureAtlas::Clear()
+	{
+		for (Page& page : m_Pages)
+			Renderer::DestroyTexture(page.PageTexture);
+
+		m_Pages.clear();
+		m_Regions.clear();
+	}
+
+	bool TextureAtlas::Pack(Page& page, int32_t width, int32_t height, int32_t& x, int32_t& y)
+	{
+		std::vector<SkylineSegment>& skyline = page.Skyline;
+
+		//bottom left rule: the rectangle starts at the left of a segment and rests on the highest segment under it
+		size_t bestIndex = skyline.size();
+		int32_t bestTop = std::numeric_limits<int32_t>::max();
+		for (size_t i = 0; i < skyline.size(); i++)
+		{
+			if (skyline[i].X + width > c_PageSize)
+				break;
+
+			int32_t bottom = 0;
+			int32_t widthLeft = width;
+			for (size_t j = i; widthLeft > 0; j++)
+			{
+				bottom = std::max(bottom, skyline[j].Y);
+				widthLeft -= skyline[j].Width;
+			}
+
+			if (bottom + height <= c_PageSize && bottom + height < bestTop)
+			{
+				bestIndex = i;
+				bestTop = bottom + height;
+			}
+		}
+
+		if (bestIndex == skyline.size())
+			return false;
+
+		x = skyline[bestIndex].X;
+		y = bestTop - height;
+
+		//the new segment covers the start of the segments under the rectangle
+		skyline.insert(skyline.begin() + bestIndex, { x, bestTop, width });
+		size_t next = bestIndex + 1;
+		while (next < skyline.size() && skyline[next].X < x + width)
+		{
+			int32_t overlap = x + width - skyline[next].X;
+			if (overlap < skyline[next].Width)
+			{
+				skyline[next].X += overlap;
+				skyline[next].Width -= overlap;
+				break;
+			}
+			skyline.erase(skyline.begin() + next);
+		}
+
+		//merge neighbouring segments at the same height
+		for (size_t i = 0; i + 1 < skyline.size();)
+		{
+			if (skyline[i].Y == skyline[i + 1].Y)
+			{
+				skyline[i].Width += skyline[i + 1].Width;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else
+				i++;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Texture.h"
+
+namespace Ainan {
+
+	//a part of an atlas page, draw a quad with Page as the texture and the UVs as the texture coordinates of its corners
+	struct AtlasRegion
+	{
+		Texture Page;
+		glm::vec2 UVMin = { 0.0f, 0.0f };
+		glm::vec2 UVMax = { 1.0f, 1.0f };
+
+		bool IsValid() { return Page.IsValid(); }
+	};
+
+	//packs small RGBA images into big textures (pages) so that quads with different images can be drawn with the same texture.
+	//images are packed with a skyline packer one at a time as they are added, the images already in a page never move,
+	//so adding an image only uploads that image. pages are texture arrays with one layer that quads sample directly
+	class TextureAtlas
+	{
+	public:
+		static constexpr int32_t c_PageSize = 2048;
+		//bigger images use too much of a page, they should have their own texture
+		static constexpr int32_t c_MaxImageSize = 512;
+		//empty pixels around every image so that filtering at its edges doesn't read its neighbours
+		static constexpr int32_t c_Padding = 1;
+
+		//name identifies the image, adding a name that's already in the atlas returns the region it was given.
+		//every Add that returns a valid region has to be matched by a Remove when the image isn't used anymore.
+		//returns an invalid region if the image isn't RGBA or is bigger than c_MaxImageSize
+		AtlasRegion Add(const std::string& name, const Image& image);
+		//when every Add of the name is removed the atlas forgets it, so adding it again uploads the image again.
+		//the image stays in its page until Clear because the images in a page never move
+		void Remove(const std::string& name);
+		//returns an invalid region if nothing was added with that name
+		AtlasRegion Find(const std::string& name) const;
+
+		//a name for an image file that changes when the file is modified, so that an edited image isn't drawn from
+		//an old copy in the atlas
+		static std::string GetImageName(const std::filesystem::path& path);
+
+		//destroys all the pages, the regions given before this are invalid after it
+		void Clear();
+
+	private:
+		//the top of the packed images from X to X + Width, the segments of a page cover its whole width from left to right
+		struct SkylineSegment
+		{
+			int32_t X;
+			int32_t Y;
+			int32_t Width;
+		};
+
+		struct Page
+		{
+			Texture PageTexture;
+			std::vector<SkylineSegment> Skyline;
+		};
+
+		struct Entry
+		{
+			AtlasRegion Region;
+			//the number of Adds of the name that weren't removed yet
+			uint32_t UserCount = 0;
+		};
+
+		//finds a place for a width * height rectangle where its top is as low as possible and adds it to the skyline
+		static bool Pack(Page& page, int32_t width, int32_t height, int32_t& x, int32_t& y);
+
+	private:
+		std::vector<Page> m_Pages;
+		std::unordered_map<std::string, Entry> m_Regions;
+	};
+}
@@ -10,7 +10,7 @@ namespace Ainan
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::UpdateUniformBuffer;
 		cmd.UpdateUniformBufferCmdDesc.Buffer = &Renderer::Rdata->UniformBuffers[Identifier];
-		void* dataCpy = new uint8_t[packedDataSizeofBuffer];
+		void* dataCpy = Renderer::Rdata->CommandQueue.AllocatePayload<uint8_t>(packedDataSizeofBuffer);
 		memcpy(dataCpy, data, packedDataSizeofBuffer);
 		cmd.UpdateUniformBufferCmdDesc.Data = dataCpy;
 		Renderer::PushCommand(cmd);
@@ -5,13 +5,14 @@
 
 namespace Ainan
 {
-	void VertexBuffer::UpdateData(int32_t offset, int32_t size, void* data)
+	void VertexBuffer::UpdateData(int32_t offset, int32_t size, void* data, bool noOverwrite)
 	{
 		RenderCommand cmd;
 		cmd.Type = RenderCommandType::UpdateVertexBuffer;
 		cmd.UpdateVertexBufferCmdDesc.Size = size;
 		cmd.UpdateVertexBufferCmdDesc.Offset = offset;
-		cmd.UpdateVertexBufferCmdDesc.Data = new uint8_t[size];
+		cmd.UpdateVertexBufferCmdDesc.NoOverwrite = noOverwrite;
+		cmd.UpdateVertexBufferCmdDesc.Data = Renderer::Rdata->CommandQueue.AllocatePayload<uint8_t>(size);
 		memcpy(cmd.UpdateVertexBufferCmdDesc.Data, data, size);
 		cmd.UpdateVertexBufferCmdDesc.VertexBuffer = &Renderer::Rdata->VertexBuffers[Identifier];
 
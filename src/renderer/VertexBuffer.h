@@ -94,7 +94,8 @@ namespace Ainan {
 
 		//NOTE: offset and size are in bytes
 		//offset is the start of the memory location you want to update
-		void UpdateData(int32_t offset, int32_t size, void* data);
+		//noOverwrite is for buffers that are filled a part at a time while the parts before are drawn, see UpdateVertexBufferCmdDesc
+		void UpdateData(int32_t offset, int32_t size, void* data, bool noOverwrite = false);
 		uint32_t GetUsedMemory() const;
 	};
 
@@ -105,9 +106,20 @@ namespace Ainan {
 		uint64_t Layout;
 		uint32_t Array; //Used only in OpenGL
 		uint32_t Stride;
+		//only set for buffers created as persistently mapped on apis that support it.
+		//this stays valid until the buffer is destroyed and can be written from any thread
+		uint8_t* MappedData = nullptr;
 		bool Deleted = false;
 	};
 
+	//a point in the command stream of the gpu, used to know when the gpu is done reading from a buffer
+	struct FenceDataView
+	{
+		uint64_t Identifier = 0;
+		//set by the renderer thread once the gpu has passed the fence
+		std::atomic_bool Signaled = true;
+	};
+
 	//returns size in bytes
 	constexpr int GetShaderVariableComponentCount(const ShaderVariableType& type)
 	{
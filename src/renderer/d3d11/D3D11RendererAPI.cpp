@@ -398,45 +398,22 @@ namespace Ainan {
 			ImDrawData* src = ImGui::GetDrawData();
 			auto io = ImGui::GetPlatformIO();
 
-			auto drawDataCpy = [](ImDrawData* inData) -> ImDrawData*
-			{
-				ImDrawData* data = new ImDrawData;
-				memcpy(data, inData, sizeof(ImDrawData));
-				data->CmdLists = new ImDrawList * [inData->CmdListsCount];
-				for (size_t i = 0; i < inData->CmdListsCount; i++)
-				{
-					data->CmdLists[i] = new ImDrawList(ImGui::GetDrawListSharedData());
-					data->CmdLists[i] = inData->CmdLists[i]->CloneOutput();
-				}
-				return data;
-			};
-
-			auto drawDataDelete = [](ImDrawData* data)
-			{
-				for (size_t i = 0; i < data->CmdListsCount; i++)
-				{
-					delete data->CmdLists[i];
-				}
-				delete[] data->CmdLists;
-				delete data;
-			};
-
-			ImDrawData* mainVPData = drawDataCpy(ImGui::GetDrawData());
+			ImDrawData* mainVPData = Renderer::CopyImGuiDrawData(ImGui::GetDrawData());
 
 			std::vector<std::pair<ImGuiID, ImDrawData*>> otherVPsData;
 			for (size_t i = 0; i < io.Viewports.size(); i++)
 			{
-				otherVPsData.push_back(std::make_pair(io.Viewports[i]->ID, drawDataCpy(io.Viewports[i]->DrawData)));
+				otherVPsData.push_back(std::make_pair(io.Viewports[i]->ID, Renderer::CopyImGuiDrawData(io.Viewports[i]->DrawData)));
 			}
 
-			auto func = [this, drawDataDelete, mainVPData, otherVPsData]()
+			auto func = [this, mainVPData, otherVPsData]()
 			{
 				DrawImGui(mainVPData);
 				ImGui::RenderPlatformWindowsDefault(0, (void*)&otherVPsData);
 
-				drawDataDelete(mainVPData);
+				Renderer::DeleteImGuiDrawData(mainVPData);
 				for (size_t i = 0; i < otherVPsData.size(); i++)
-					drawDataDelete(otherVPsData[i].second);
+					Renderer::DeleteImGuiDrawData(otherVPsData[i].second);
 			};
 
 			Renderer::PushCommand(func);
@@ -534,6 +511,18 @@ namespace Ainan {
 				ReadFramebuffer(cmd);
 				break;
 
+			case RenderCommandType::ReadFramebufferAsync:
+				ReadFramebufferAsync(cmd);
+				break;
+
+			case RenderCommandType::MapReadbackBuffer:
+				MapReadbackBuffer(cmd);
+				break;
+
+			case RenderCommandType::DestroyReadbackBuffer:
+				DestroyReadbackBuffer(cmd);
+				break;
+
 			case RenderCommandType::DestroyFramebuffer:
 				DestroyFramebuffer(cmd);
 				break;
@@ -550,6 +539,18 @@ namespace Ainan {
 				UpdateTexture(cmd);
 				break;
 
+			case RenderCommandType::UpdateTextureRegion:
+				UpdateTextureRegion(cmd);
+				break;
+
+			case RenderCommandType::CopyTexture:
+				CopyTexture(cmd);
+				break;
+
+			case RenderCommandType::ClearTexture:
+				ClearTexture(cmd);
+				break;
+
 			case RenderCommandType::DestroyTexture:
 				DestroyTexture(cmd);
 				break;
@@ -566,6 +567,17 @@ namespace Ainan {
 				DrawIndexedNewWithCustomNumberOfVertices(cmd);
 				break;
 
+			case RenderCommandType::DrawInstanced:
+				DrawInstanced(cmd);
+				break;
+
+			//streaming vertex buffers aren't persistently mapped on D3D11, they are written with D3D11_MAP_WRITE_NO_OVERWRITE
+			//and discarded when they wrap around, so the driver keeps track of what the gpu reads and nothing inserts fences
+			case RenderCommandType::InsertFence:
+			case RenderCommandType::WaitFence:
+				assert(false);
+				break;
+
 			default:
 				break;
 			}
@@ -667,8 +679,8 @@ namespace Ainan {
 					desc[i].SemanticIndex = info->Layout[i].SemanticIndex;
 					desc[i].Format = GetD3D11FormatFromShaderType(info->Layout[i].Type);
 					desc[i].InputSlot = 0;
-					desc[i].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-					desc[i].InstanceDataStepRate = 0;
+					desc[i].InputSlotClass = info->PerInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA;
+					desc[i].InstanceDataStepRate = info->PerInstance ? 1 : 0;
 					desc[i].AlignedByteOffset = output->Stride;
 					output->Stride += info->Layout[i].GetSize();
 				}
@@ -676,7 +688,6 @@ namespace Ainan {
 				ASSERT_D3D_CALL(Context.Device->CreateInputLayout(desc.data(), desc.size(), info->Shader->VertexByteCode, info->Shader->VertexByteCodeSize, (ID3D11InputLayout**)&output->Layout));
 			}
 
-			delete[] info->InitialData;
 			delete info;
 		}
 
@@ -684,13 +695,13 @@ namespace Ainan {
 		{
 			D3D11_MAPPED_SUBRESOURCE resource{};
 
-			ASSERT_D3D_CALL(Context.DeviceContext->Map((ID3D11Resource*)cmd.UpdateVertexBufferCmdDesc.VertexBuffer->Identifier, 0, D3D11_MAP_WRITE_DISCARD, 0, &resource));
+			//no overwrite keeps the parts of the buffer draws that are already recorded read, discard gives a new buffer
+			D3D11_MAP mapType = cmd.UpdateVertexBufferCmdDesc.NoOverwrite ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD;
+			ASSERT_D3D_CALL(Context.DeviceContext->Map((ID3D11Resource*)cmd.UpdateVertexBufferCmdDesc.VertexBuffer->Identifier, 0, mapType, 0, &resource));
 
 			memcpy((uint8_t*)resource.pData + cmd.UpdateVertexBufferCmdDesc.Offset, cmd.UpdateVertexBufferCmdDesc.Data, cmd.UpdateVertexBufferCmdDesc.Size);
 
 			Context.DeviceContext->Unmap((ID3D11Resource*)cmd.UpdateVertexBufferCmdDesc.VertexBuffer->Identifier, 0);
-
-			delete[] cmd.UpdateVertexBufferCmdDesc.Data;
 		}
 
 		void D3D11RendererAPI::DestroyVertexBuffer(const RenderCommand& cmd)
@@ -720,9 +731,6 @@ namespace Ainan {
 			{
 				ASSERT_D3D_CALL(Context.Device->CreateBuffer(&desc, 0, (ID3D11Buffer**)&output->Identifier));
 			}
-
-			delete[] info->InitialData;
-			delete info;
 		}
 
 		void D3D11RendererAPI::DestroyIndexBuffer(const RenderCommand& cmd)
@@ -836,7 +844,6 @@ namespace Ainan {
 			}
 
 			Context.DeviceContext->Unmap((ID3D11Resource*)cmd.UpdateUniformBufferCmdDesc.Buffer->Identifier, 0);
-			delete[] unalignedData;
 		}
 
 		void D3D11RendererAPI::DestroyUniformBuffer(const RenderCommand& cmd)
@@ -885,8 +892,6 @@ namespace Ainan {
 			samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
 
 			ASSERT_D3D_CALL(Context.Device->CreateSamplerState(&samplerDesc, (ID3D11SamplerState**)&output->SamplerIdentifier));
-
-			delete info;
 		}
 
 		void D3D11RendererAPI::BindFramebufferAsTexture(const RenderCommand& cmd)
@@ -1005,6 +1010,69 @@ namespace Ainan {
 			stagingTexture->Release();
 		}
 
+		void D3D11RendererAPI::ReadFramebufferAsync(const RenderCommand& cmd)
+		{
+			FramebufferDataView* buffer = cmd.ReadFramebufferAsyncCmdDesc.Buffer;
+			ReadbackBufferDataView* output = cmd.ReadFramebufferAsyncCmdDesc.Output;
+
+			//the staging texture can't be copied into while it's mapped from the last read
+			if (output->MappedData)
+			{
+				Context.DeviceContext->Unmap((ID3D11Texture2D*)output->Identifier, 0);
+				output->MappedData = nullptr;
+			}
+
+			if (output->Identifier == 0 || output->Size != buffer->Size)
+			{
+				if (output->Identifier != 0)
+					((ID3D11Texture2D*)output->Identifier)->Release();
+
+				D3D11_TEXTURE2D_DESC desc{};
+				desc.Width = (uint32_t)buffer->Size.x;
+				desc.Height = (uint32_t)buffer->Size.y;
+				desc.SampleDesc.Count = 1;
+				desc.Usage = D3D11_USAGE_STAGING;
+				desc.BindFlags = 0;
+				desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+				desc.ArraySize = 1;
+				desc.MipLevels = 1;
+				desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+				ID3D11Texture2D* stagingTexture = nullptr;
+				ASSERT_D3D_CALL(Context.Device->CreateTexture2D(&desc, nullptr, &stagingTexture));
+				output->Identifier = (uint64_t)stagingTexture;
+				output->Size = buffer->Size;
+			}
+
+			Context.DeviceContext->CopyResource((ID3D11Texture2D*)output->Identifier, (ID3D11Resource*)buffer->TextureIdentifier);
+		}
+
+		void D3D11RendererAPI::MapReadbackBuffer(const RenderCommand& cmd)
+		{
+			ReadbackBufferDataView* buffer = cmd.MapReadbackBufferCmdDesc.Buffer;
+
+			//Map waits for the copy into the staging texture so no fence is needed here
+			D3D11_MAPPED_SUBRESOURCE resource{};
+			ASSERT_D3D_CALL(Context.DeviceContext->Map((ID3D11Texture2D*)buffer->Identifier, 0, D3D11_MAP_READ, 0, &resource));
+
+			buffer->MappedData = (uint8_t*)resource.pData;
+			buffer->RowPitch = resource.RowPitch;
+			buffer->Fence.Signaled.store(true, std::memory_order_release);
+		}
+
+		void D3D11RendererAPI::DestroyReadbackBuffer(const RenderCommand& cmd)
+		{
+			ReadbackBufferDataView* buffer = cmd.DestroyReadbackBufferCmdDesc.Buffer;
+			ID3D11Texture2D* stagingTexture = (ID3D11Texture2D*)buffer->Identifier;
+
+			if (buffer->MappedData)
+				Context.DeviceContext->Unmap(stagingTexture, 0);
+			stagingTexture->Release();
+
+			buffer->Identifier = 0;
+			buffer->MappedData = nullptr;
+		}
+
 		void D3D11RendererAPI::DestroyFramebuffer(const RenderCommand& cmd)
 		{
 			((ID3D11SamplerState*)cmd.DestroyFramebufferCmdDesc.Buffer->SamplerIdentifier)->Release();
@@ -1107,13 +1175,101 @@ namespace Ainan {
 
 				ASSERT_D3D_CALL(Context.Device->CreateSamplerState(&samplerDesc, (ID3D11SamplerState**)&output->Sampler));
 			}
+			else if (info->Type == TextureType::Texture2DArray)
+			{
+				//the layers are filled with CopyTexture, ClearTexture or UpdateTextureRegion, so the texture is created without data.
+				//it's a render target so that ClearTexture can clear it on the gpu
+				D3D11_TEXTURE2D_DESC desc{};
+				desc.Width = info->Size.x;
+				desc.Height = info->Size.y;
+				desc.SampleDesc.Count = 1;
+				desc.Usage = D3D11_USAGE_DEFAULT;
+				desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+				desc.ArraySize = info->Layers;
+				desc.MipLevels = 1;
+				desc.Format = D3DFormat(info->Format);
+				ASSERT_D3D_CALL(Context.Device->CreateTexture2D(&desc, nullptr, (ID3D11Texture2D**)&output->Identifier));
+
+				D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc{};
+				viewDesc.Format = D3DFormat(info->Format);
+				viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+				viewDesc.Texture2DArray.MostDetailedMip = 0;
+				viewDesc.Texture2DArray.MipLevels = 1;
+				viewDesc.Texture2DArray.FirstArraySlice = 0;
+				viewDesc.Texture2DArray.ArraySize = info->Layers;
+				ASSERT_D3D_CALL(Context.Device->CreateShaderResourceView((ID3D11Resource*)output->Identifier, &viewDesc, (ID3D11ShaderResourceView**)&output->View));
+
+				if (info->Layers == 1)
+				{
+					D3D11_SHADER_RESOURCE_VIEW_DESC layerViewDesc{};
+					layerViewDesc.Format = D3DFormat(info->Format);
+					layerViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+					layerViewDesc.Texture2D.MipLevels = 1;
+					ASSERT_D3D_CALL(Context.Device->CreateShaderResourceView((ID3D11Resource*)output->Identifier, &layerViewDesc, (ID3D11ShaderResourceView**)&output->LayerView));
+				}
+
+				D3D11_SAMPLER_DESC samplerDesc{};
+				samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
+				samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+				samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+				samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+				samplerDesc.MaxAnisotropy = 1;
+				samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+				samplerDesc.BorderColor[3] = 1.0f;
+				samplerDesc.MaxLOD = 1.0f;
+
+				ASSERT_D3D_CALL(Context.Device->CreateSamplerState(&samplerDesc, (ID3D11SamplerState**)&output->Sampler));
+			}
 			else
 				assert(false);
 
 			output->Size = info->Size;
+			output->Layers = info->Layers;
+		}
 
-			delete[] info->InitialData;
-			delete info;
+		void D3D11RendererAPI::UpdateTextureRegion(const RenderCommand& cmd)
+		{
+			D3D11_BOX box{};
+			box.left = cmd.UpdateTextureRegionCmdDesc.X;
+			box.top = cmd.UpdateTextureRegionCmdDesc.Y;
+			box.right = cmd.UpdateTextureRegionCmdDesc.X + cmd.UpdateTextureRegionCmdDesc.Width;
+			box.bottom = cmd.UpdateTextureRegionCmdDesc.Y + cmd.UpdateTextureRegionCmdDesc.Height;
+			box.front = 0;
+			box.back = 1;
+
+			uint32_t rowPitch = cmd.UpdateTextureRegionCmdDesc.Width * GetBytesPerPixel(cmd.UpdateTextureRegionCmdDesc.Texture->Format);
+			Context.DeviceContext->UpdateSubresource((ID3D11Resource*)cmd.UpdateTextureRegionCmdDesc.Texture->Identifier, 0, &box,
+				cmd.UpdateTextureRegionCmdDesc.Data, rowPitch, 0);
+		}
+
+		void D3D11RendererAPI::CopyTexture(const RenderCommand& cmd)
+		{
+			TextureDataView* source = cmd.CopyTextureCmdDesc.Source;
+			TextureDataView* destination = cmd.CopyTextureCmdDesc.Destination;
+
+			//every layer is a subresource with a single mip level
+			for (uint32_t i = 0; i < cmd.CopyTextureCmdDesc.LayerCount; i++)
+				Context.DeviceContext->CopySubresourceRegion((ID3D11Resource*)destination->Identifier,
+					D3D11CalcSubresource(0, cmd.CopyTextureCmdDesc.DestinationLayer + i, 1), 0, 0, 0,
+					(ID3D11Resource*)source->Identifier, D3D11CalcSubresource(0, cmd.CopyTextureCmdDesc.SourceLayer + i, 1), nullptr);
+		}
+
+		void D3D11RendererAPI::ClearTexture(const RenderCommand& cmd)
+		{
+			TextureDataView* texture = cmd.ClearTextureCmdDesc.Texture;
+
+			D3D11_RENDER_TARGET_VIEW_DESC viewDesc{};
+			viewDesc.Format = D3DFormat(texture->Format);
+			viewDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+			viewDesc.Texture2DArray.MipSlice = 0;
+			viewDesc.Texture2DArray.FirstArraySlice = 0;
+			viewDesc.Texture2DArray.ArraySize = texture->Layers;
+
+			ID3D11RenderTargetView* view = nullptr;
+			ASSERT_D3D_CALL(Context.Device->CreateRenderTargetView((ID3D11Resource*)texture->Identifier, &viewDesc, &view));
+			const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			Context.DeviceContext->ClearRenderTargetView(view, clearColor);
+			view->Release();
 		}
 
 		void D3D11RendererAPI::BindTexture(const RenderCommand& cmd)
@@ -1243,13 +1399,14 @@ namespace Ainan {
 			}
 			
 			cmd.UpdateTextureCmdDesc.Texture->Size = { cmd.UpdateTextureCmdDesc.Width , cmd.UpdateTextureCmdDesc.Height };
-			delete[] cmd.UpdateTextureCmdDesc.Data;
 		}
 
 		void D3D11RendererAPI::DestroyTexture(const RenderCommand& cmd)
 		{
 			((ID3D11SamplerState*)cmd.DestroyTextureCmdDesc.Texture->Sampler)->Release();
 			((ID3D11ShaderResourceView*)cmd.DestroyTextureCmdDesc.Texture->View)->Release();
+			if (cmd.DestroyTextureCmdDesc.Texture->LayerView != std::numeric_limits<uint64_t>::max())
+				((ID3D11ShaderResourceView*)cmd.DestroyTextureCmdDesc.Texture->LayerView)->Release();
 			((ID3D11Texture2D*)cmd.DestroyTextureCmdDesc.Texture->Identifier)->Release();
 			cmd.DestroyTextureCmdDesc.Texture->Deleted = true;
 		}
@@ -1297,7 +1454,21 @@ namespace Ainan {
 
 			Context.DeviceContext->IASetIndexBuffer((ID3D11Buffer*)cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.IndexBuffer->Identifier, DXGI_FORMAT_R32_UINT, 0);
 
-			Context.DeviceContext->DrawIndexed(cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.IndexCount, 0, 0);
+			Context.DeviceContext->DrawIndexed(cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.IndexCount, 0, cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.BaseVertex);
+		}
+
+		void D3D11RendererAPI::DrawInstanced(const RenderCommand& cmd)
+		{
+			Context.DeviceContext->IASetPrimitiveTopology(GetD3DPrimitive(cmd.DrawInstancedCmdDesc.DrawingPrimitive));
+
+			Context.DeviceContext->VSSetShader((ID3D11VertexShader*)cmd.DrawInstancedCmdDesc.Shader->Identifier, 0, 0);
+			Context.DeviceContext->PSSetShader((ID3D11PixelShader*)cmd.DrawInstancedCmdDesc.Shader->Identifier_1, 0, 0);
+
+			uint32_t offset = 0;
+			Context.DeviceContext->IASetVertexBuffers(0, 1, (ID3D11Buffer**)&cmd.DrawInstancedCmdDesc.VertexBuffer->Identifier, &cmd.DrawInstancedCmdDesc.VertexBuffer->Stride, &offset);
+			Context.DeviceContext->IASetInputLayout((ID3D11InputLayout*)cmd.DrawInstancedCmdDesc.VertexBuffer->Layout);
+
+			Context.DeviceContext->DrawInstanced(cmd.DrawInstancedCmdDesc.VertexCount, cmd.DrawInstancedCmdDesc.InstanceCount, 0, cmd.DrawInstancedCmdDesc.FirstInstance);
 		}
 
 		void D3D11RendererAPI::InitImGui()
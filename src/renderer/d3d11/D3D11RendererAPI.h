@@ -18,6 +18,8 @@ namespace Ainan {
 			virtual ~D3D11RendererAPI();
 
 			virtual void ExecuteCommand(RenderCommand cmd) override;
+			//D3D11 doesn't insert fences, see the InsertFence case in ExecuteCommand
+			virtual void PollFences() override {}
 
 			virtual void InitImGui() override;
 			virtual void TerminateImGui() override;
@@ -48,14 +50,21 @@ namespace Ainan {
 			void BindWindowFramebufferAsRenderTarget(const RenderCommand& cmd);
 			void ResizeFramebuffer(const RenderCommand& cmd);
 			void ReadFramebuffer(const RenderCommand& cmd);
+			void ReadFramebufferAsync(const RenderCommand& cmd);
+			void MapReadbackBuffer(const RenderCommand& cmd);
+			void DestroyReadbackBuffer(const RenderCommand& cmd);
 			void DestroyFramebuffer(const RenderCommand& cmd);
 			void CreateTexture(const RenderCommand& cmd);
 			void BindTexture(const RenderCommand& cmd);
 			void UpdateTexture(const RenderCommand& cmd);
+			void UpdateTextureRegion(const RenderCommand& cmd);
+			void CopyTexture(const RenderCommand& cmd);
+			void ClearTexture(const RenderCommand& cmd);
 			void DestroyTexture(const RenderCommand& cmd);
 			void DrawNew(const RenderCommand& cmd);
 			void DrawIndexed(const RenderCommand& cmd);
 			void DrawIndexedNewWithCustomNumberOfVertices(const RenderCommand& cmd);
+			void DrawInstanced(const RenderCommand& cmd);
 			void SetViewport(const Rectangle& viewport);
 			void SetViewport(const RenderCommand& cmd);
 		public:
@@ -0,0 +1,94 @@
+#include "OpenGLHeadlessContext.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace Ainan {
+	namespace OpenGL {
+
+		static EGLDisplay s_Display = EGL_NO_DISPLAY;
+		static EGLContext s_Context = EGL_NO_CONTEXT;
+
+		bool OpenGLHeadlessContext::Create()
+		{
+			//the surfaceless platform doesn't connect to X or wayland, fall back to the default display if it's not there
+			auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+			if (getPlatformDisplay)
+				s_Display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+			if (s_Display == EGL_NO_DISPLAY)
+				s_Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+			EGLint major = 0;
+			EGLint minor = 0;
+			if (s_Display == EGL_NO_DISPLAY || eglInitialize(s_Display, &major, &minor) == EGL_FALSE)
+			{
+				AINAN_LOG_ERROR("Cannot initialize EGL");
+				return false;
+			}
+
+			//the default surface type is a window, the surfaceless platform only has pbuffer configs
+			const EGLint configAttributes[] =
+			{
+				EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+				EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+				EGL_RED_SIZE, 8,
+				EGL_GREEN_SIZE, 8,
+				EGL_BLUE_SIZE, 8,
+				EGL_ALPHA_SIZE, 8,
+				EGL_NONE
+			};
+			EGLConfig config;
+			EGLint configCount = 0;
+			if (eglChooseConfig(s_Display, configAttributes, &config, 1, &configCount) == EGL_FALSE || configCount == 0)
+			{
+				AINAN_LOG_ERROR("Cannot find an EGL config that supports OpenGL");
+				return false;
+			}
+
+			eglBindAPI(EGL_OPENGL_API);
+
+			//4.5 is the newest version the software rasterizer supports and has everything the renderer uses
+			const EGLint contextAttributes[] =
+			{
+				EGL_CONTEXT_MAJOR_VERSION, 4,
+				EGL_CONTEXT_MINOR_VERSION, 5,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#ifndef NDEBUG
+				EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+#endif // !NDEBUG
+				EGL_NONE
+			};
+			s_Context = eglCreateContext(s_Display, config, EGL_NO_CONTEXT, contextAttributes);
+			if (s_Context == EGL_NO_CONTEXT)
+			{
+				AINAN_LOG_ERROR("Cannot create an OpenGL 4.5 context with EGL");
+				eglTerminate(s_Display);
+				s_Display = EGL_NO_DISPLAY;
+				return false;
+			}
+
+			//no surfaces, this needs EGL_KHR_surfaceless_context which every mesa driver has
+			eglMakeCurrent(s_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, s_Context);
+			return true;
+		}
+
+		void OpenGLHeadlessContext::Destroy()
+		{
+			if (s_Display == EGL_NO_DISPLAY)
+				return;
+
+			eglMakeCurrent(s_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if (s_Context != EGL_NO_CONTEXT)
+				eglDestroyContext(s_Display, s_Context);
+			eglTerminate(s_Display);
+
+			s_Context = EGL_NO_CONTEXT;
+			s_Display = EGL_NO_DISPLAY;
+		}
+
+		void* OpenGLHeadlessContext::GetProcAddress(const char* name)
+		{
+			return (void*)eglGetProcAddress(name);
+		}
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace Ainan {
+	namespace OpenGL {
+
+		//an OpenGL context that isn't attached to a window, made with EGL on mesa's surfaceless platform so it needs
+		//no display server. on a machine without a gpu mesa runs it on the llvmpipe software rasterizer.
+		//there is no default framebuffer, everything has to be drawn to framebuffers
+		class OpenGLHeadlessContext
+		{
+		public:
+			//creates the context and makes it current on the calling thread, returns false if EGL can't make one
+			static bool Create();
+			static void Destroy();
+
+			//used to load the OpenGL functions with glad
+			static void* GetProcAddress(const char* name);
+		};
+	}
+}
@@ -5,6 +5,10 @@
 #include <GLFW/glfw3.h>
 #include "file/AssetManager.h" //for reading shader files
 
+#ifndef PLATFORM_WINDOWS
+#include "OpenGLHeadlessContext.h"
+#endif // !PLATFORM_WINDOWS
+
 namespace Ainan {
 	namespace OpenGL {
 		bool                 WantUpdateMonitors = true;
@@ -121,8 +125,19 @@ namespace Ainan {
 
 		OpenGLRendererAPI::OpenGLRendererAPI()
 		{
-			glfwMakeContextCurrent(Window::Ptr);
-			gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+#ifndef PLATFORM_WINDOWS
+			if (Window::Headless)
+			{
+				if (!OpenGLHeadlessContext::Create())
+					AINAN_LOG_FATAL("Cannot create a headless OpenGL context");
+				gladLoadGLLoader((GLADloadproc)OpenGLHeadlessContext::GetProcAddress);
+			}
+			else
+#endif // !PLATFORM_WINDOWS
+			{
+				glfwMakeContextCurrent(Window::Ptr);
+				gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+			}
 #ifndef NDEBUG
 			glDebugMessageCallback(&opengl_debug_message_callback, nullptr);
 #endif // DEBUG
@@ -146,6 +161,15 @@ namespace Ainan {
 		{
 			SingletonInstance = nullptr;
 
+			//ImGui isn't used in headless mode
+			if (Window::Headless)
+			{
+#ifndef PLATFORM_WINDOWS
+				OpenGLHeadlessContext::Destroy();
+#endif // !PLATFORM_WINDOWS
+				return;
+			}
+
 			//terminate ImGui
 			ImGui::DestroyPlatformWindows();
 			if (FontTexture)
@@ -256,6 +280,18 @@ namespace Ainan {
 				ReadFramebuffer(cmd);
 				break;
 
+			case RenderCommandType::ReadFramebufferAsync:
+				ReadFramebufferAsync(cmd);
+				break;
+
+			case RenderCommandType::MapReadbackBuffer:
+				MapReadbackBuffer(cmd);
+				break;
+
+			case RenderCommandType::DestroyReadbackBuffer:
+				DestroyReadbackBuffer(cmd);
+				break;
+
 			case RenderCommandType::DestroyFramebuffer:
 				DestroyFramebufferNew(cmd);
 				break;
@@ -276,6 +312,18 @@ namespace Ainan {
 				DrawNew(cmd);
 				break;
 
+			case RenderCommandType::DrawInstanced:
+				DrawInstanced(cmd);
+				break;
+
+			case RenderCommandType::InsertFence:
+				InsertFence(cmd);
+				break;
+
+			case RenderCommandType::WaitFence:
+				WaitFence(cmd);
+				break;
+
 			case RenderCommandType::UpdateVertexBuffer:
 				UpdateVertexBufferNew(cmd);
 				break;
@@ -284,6 +332,18 @@ namespace Ainan {
 				UpdateTextureNew(cmd);
 				break;
 
+			case RenderCommandType::UpdateTextureRegion:
+				UpdateTextureRegion(cmd);
+				break;
+
+			case RenderCommandType::CopyTexture:
+				CopyTexture(cmd);
+				break;
+
+			case RenderCommandType::ClearTexture:
+				ClearTexture(cmd);
+				break;
+
 			case RenderCommandType::DestroyTexture:
 				DestroyTexture(cmd);
 				break;
@@ -300,6 +360,10 @@ namespace Ainan {
 					glBindTexture(GL_TEXTURE_CUBE_MAP, (uint32_t)cmd.BindTextureProgramCmdDesc.Texture->Identifier);
 					break;
 
+				case TextureType::Texture2DArray:
+					glBindTexture(GL_TEXTURE_2D_ARRAY, (uint32_t)cmd.BindTextureProgramCmdDesc.Texture->Identifier);
+					break;
+
 				default:
 					AINAN_LOG_FATAL("Unkown texture type")
 				}
@@ -356,7 +420,6 @@ namespace Ainan {
 
 			output->Identifier = bufferHandle;
 			output->TextureIdentifier = textureHandle;
-			delete info;
 		}
 
 		void OpenGLRendererAPI::CreateShaderProgram(const RenderCommand& cmd)
@@ -458,8 +521,6 @@ namespace Ainan {
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
 			output->Identifier = bufferHandle;
-			delete info->InitialData;
-			delete info;
 		}
 
 		void OpenGLRendererAPI::UpdateUniformBufferNew(const RenderCommand& cmd)
@@ -497,8 +558,6 @@ namespace Ainan {
 			glBindBuffer(GL_UNIFORM_BUFFER, buffer->Identifier);
 			glBufferSubData(GL_UNIFORM_BUFFER, 0, buffer->AlignedSize, buffer->BufferMemory);
 			glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-			delete[] unalignedData;
 		}
 
 		void OpenGLRendererAPI::BindUniformBufferNew(const RenderCommand& cmd)
@@ -520,7 +579,14 @@ namespace Ainan {
 			glBindVertexArray(arrayHandle);
 			glGenBuffers(1, &bufferHandle);
 			glBindBuffer(GL_ARRAY_BUFFER, bufferHandle);
-			if (info->Dynamic)
+			if (info->PersistentlyMapped)
+			{
+				//coherent so that writes from the main thread are seen by the draws after them without flushing
+				GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+				glBufferStorage(GL_ARRAY_BUFFER, info->Size, info->InitialData, flags);
+				output->MappedData = (uint8_t*)glMapBufferRange(GL_ARRAY_BUFFER, 0, info->Size, flags);
+			}
+			else if (info->Dynamic)
 				glBufferData(GL_ARRAY_BUFFER, info->Size, info->InitialData, GL_DYNAMIC_DRAW);
 			else
 				glBufferData(GL_ARRAY_BUFFER, info->Size, info->InitialData, GL_STATIC_DRAW);
@@ -541,16 +607,22 @@ namespace Ainan {
 				int32_t componentCount = GetShaderVariableComponentCount(layoutPart.Type);
 				GLenum openglType = GetOpenglTypeFromShaderType(layoutPart.Type);
 
-				glVertexAttribPointer(index, componentCount, openglType, false, stride, (void*)(uintptr_t)offset);
+				//integer attributes have to go through the I version, otherwise they reach the shader converted to floats
+				if (openglType == GL_INT || openglType == GL_UNSIGNED_INT)
+					glVertexAttribIPointer(index, componentCount, openglType, stride, (void*)(uintptr_t)offset);
+				else
+					glVertexAttribPointer(index, componentCount, openglType, false, stride, (void*)(uintptr_t)offset);
 				offset += size;
 
+				if (info->PerInstance)
+					glVertexAttribDivisor(index, 1);
+
 				glEnableVertexAttribArray(index);
 				index++;
 			}
 
 			output->Array = arrayHandle;
 			output->Identifier = bufferHandle;
-			delete info->InitialData;
 			delete info;
 		}
 
@@ -558,6 +630,12 @@ namespace Ainan {
 		{
 			uint32_t varray = cmd.DestroyVertexBufferCmdDesc.Buffer->Array;
 			uint32_t buffer = cmd.DestroyVertexBufferCmdDesc.Buffer->Identifier;
+			if (cmd.DestroyVertexBufferCmdDesc.Buffer->MappedData)
+			{
+				glBindBuffer(GL_ARRAY_BUFFER, buffer);
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+				cmd.DestroyVertexBufferCmdDesc.Buffer->MappedData = nullptr;
+			}
 			glDeleteVertexArrays(1, &varray);
 			glDeleteBuffers(1, &buffer);
 			cmd.DestroyVertexBufferCmdDesc.Buffer->Deleted = true;
@@ -575,8 +653,6 @@ namespace Ainan {
 			glBindBuffer(GL_ARRAY_BUFFER, cmd.UpdateVertexBufferCmdDesc.VertexBuffer->Identifier);
 			glBindVertexArray(cmd.UpdateVertexBufferCmdDesc.VertexBuffer->Array);
 			glBufferSubData(GL_ARRAY_BUFFER, cmd.UpdateVertexBufferCmdDesc.Offset, cmd.UpdateVertexBufferCmdDesc.Size, cmd.UpdateVertexBufferCmdDesc.Data);
-
-			delete[] cmd.UpdateVertexBufferCmdDesc.Data;
 		}
 
 		void OpenGLRendererAPI::DrawIndexedWithCustomNumberOfVertices(const RenderCommand& cmd)
@@ -585,8 +661,9 @@ namespace Ainan {
 			glBindBuffer(GL_ARRAY_BUFFER, cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.VertexBuffer->Identifier);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.IndexBuffer->Identifier);
 			glUseProgram(cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.Shader->Identifier);
-			glDrawElements(GetOpenGLPrimitive(cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.DrawingPrimitive),
-				cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.IndexCount, GL_UNSIGNED_INT, nullptr);
+			glDrawElementsBaseVertex(GetOpenGLPrimitive(cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.DrawingPrimitive),
+				cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.IndexCount, GL_UNSIGNED_INT, nullptr,
+				cmd.DrawIndexedWithCustomNumberOfVerticesCmdDesc.BaseVertex);
 		}
 
 		void OpenGLRendererAPI::ReadFramebuffer(const RenderCommand& cmd)
@@ -613,6 +690,71 @@ namespace Ainan {
 			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		}
 
+		void OpenGLRendererAPI::ReadFramebufferAsync(const RenderCommand& cmd)
+		{
+			FramebufferDataView* buffer = cmd.ReadFramebufferAsyncCmdDesc.Buffer;
+			ReadbackBufferDataView* output = cmd.ReadFramebufferAsyncCmdDesc.Output;
+			uint32_t width = (uint32_t)buffer->Size.x;
+			uint32_t height = (uint32_t)buffer->Size.y;
+
+			if (output->Identifier == 0 || output->Size != buffer->Size)
+			{
+				if (output->Identifier != 0)
+				{
+					uint32_t oldBuffer = (uint32_t)output->Identifier;
+					glDeleteBuffers(1, &oldBuffer);
+				}
+
+				//mapped once for its whole life, the main thread reads the pixels straight from it after the fence is passed
+				const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+				uint32_t pixelBuffer = 0;
+				glGenBuffers(1, &pixelBuffer);
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+				glBufferStorage(GL_PIXEL_PACK_BUFFER, width * height * 4, nullptr, flags);
+				output->MappedData = (uint8_t*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, width * height * 4, flags);
+				output->Identifier = pixelBuffer;
+				output->Size = buffer->Size;
+				output->RowPitch = width * 4;
+			}
+			else
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, output->Identifier);
+
+			//with a pixel pack buffer bound glReadPixels only queues the copy and the last argument is an offset in the buffer
+			glBindFramebuffer(GL_FRAMEBUFFER, buffer->Identifier);
+			glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+			if (output->Fence.Identifier != 0)
+				glDeleteSync((GLsync)output->Fence.Identifier);
+			output->Fence.Identifier = (uint64_t)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+
+		void OpenGLRendererAPI::MapReadbackBuffer(const RenderCommand& cmd)
+		{
+			//the buffer is already mapped, the fence just has to be passed for the pixels in it to be there
+			RenderCommand waitCmd;
+			waitCmd.Type = RenderCommandType::WaitFence;
+			waitCmd.WaitFenceCmdDesc.Fence = &cmd.MapReadbackBufferCmdDesc.Buffer->Fence;
+			WaitFence(waitCmd);
+		}
+
+		void OpenGLRendererAPI::DestroyReadbackBuffer(const RenderCommand& cmd)
+		{
+			ReadbackBufferDataView* buffer = cmd.DestroyReadbackBufferCmdDesc.Buffer;
+
+			if (buffer->Fence.Identifier != 0)
+				glDeleteSync((GLsync)buffer->Fence.Identifier);
+
+			//deleting a mapped buffer unmaps it
+			uint32_t pixelBuffer = (uint32_t)buffer->Identifier;
+			glDeleteBuffers(1, &pixelBuffer);
+
+			buffer->Identifier = 0;
+			buffer->MappedData = nullptr;
+			buffer->Fence.Identifier = 0;
+		}
+
 		void OpenGLRendererAPI::DestroyFramebufferNew(const RenderCommand& cmd)
 		{
 			uint32_t buffer = cmd.DestroyFramebufferCmdDesc.Buffer->Identifier;
@@ -684,6 +826,27 @@ namespace Ainan {
 				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 				break;
 
+			case TextureType::Texture2DArray:
+				//the layers are filled with CopyTexture, ClearTexture or UpdateTextureRegion, so the storage is allocated without data
+				glBindTexture(GL_TEXTURE_2D_ARRAY, textureHandle);
+				glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, glInternalFormat, info->Size.x, info->Size.y, info->Layers);
+				//clamped like the D3D11 texture arrays, so atlas regions and layer edges don't pick up texels from the opposite side
+				glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+				if (info->Layers == 1)
+				{
+					uint32_t layerView = 0;
+					glGenTextures(1, &layerView);
+					glTextureView(layerView, GL_TEXTURE_2D, textureHandle, glInternalFormat, 0, 1, 0, 1);
+					glTextureParameteri(layerView, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+					glTextureParameteri(layerView, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+					output->LayerView = layerView;
+				}
+				break;
+
 			case TextureType::Unspecified:
 			default:
 				AINAN_LOG_FATAL("Unkown texture type specified");
@@ -691,9 +854,86 @@ namespace Ainan {
 
 			output->Identifier = textureHandle;
 			output->Size = info->Size;
+			output->Layers = info->Layers;
+		}
 
-			delete[] info->InitialData;
-			delete info;
+		void OpenGLRendererAPI::UpdateTextureRegion(const RenderCommand& cmd)
+		{
+			int32_t glFormat = 0;
+			switch (cmd.UpdateTextureRegionCmdDesc.Texture->Format)
+			{
+			case TextureFormat::RGBA:
+				glFormat = GL_RGBA;
+				break;
+
+			case TextureFormat::RGB:
+				glFormat = GL_RGB;
+				break;
+
+			case TextureFormat::RG:
+				glFormat = GL_RG;
+				break;
+
+			case TextureFormat::R:
+				glFormat = GL_RED;
+				break;
+
+			case TextureFormat::Unspecified:
+			default:
+				AINAN_LOG_FATAL("Unknown texture format specified");
+			}
+
+			//rows of formats with less than 4 bytes per pixel aren't always 4 byte aligned
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			if (cmd.UpdateTextureRegionCmdDesc.Texture->Type == TextureType::Texture2DArray)
+			{
+				glBindTexture(GL_TEXTURE_2D_ARRAY, cmd.UpdateTextureRegionCmdDesc.Texture->Identifier);
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, cmd.UpdateTextureRegionCmdDesc.X, cmd.UpdateTextureRegionCmdDesc.Y, 0,
+					cmd.UpdateTextureRegionCmdDesc.Width, cmd.UpdateTextureRegionCmdDesc.Height, 1, glFormat, GL_UNSIGNED_BYTE, cmd.UpdateTextureRegionCmdDesc.Data);
+			}
+			else
+			{
+				glBindTexture(GL_TEXTURE_2D, cmd.UpdateTextureRegionCmdDesc.Texture->Identifier);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, cmd.UpdateTextureRegionCmdDesc.X, cmd.UpdateTextureRegionCmdDesc.Y,
+					cmd.UpdateTextureRegionCmdDesc.Width, cmd.UpdateTextureRegionCmdDesc.Height, glFormat, GL_UNSIGNED_BYTE, cmd.UpdateTextureRegionCmdDesc.Data);
+			}
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+		static uint32_t GetGLTextureTarget(TextureType type)
+		{
+			switch (type)
+			{
+			case TextureType::Texture2D:
+				return GL_TEXTURE_2D;
+
+			case TextureType::Cubemap:
+				return GL_TEXTURE_CUBE_MAP;
+
+			case TextureType::Texture2DArray:
+				return GL_TEXTURE_2D_ARRAY;
+
+			case TextureType::Unspecified:
+			default:
+				AINAN_LOG_FATAL("Unkown texture type specified");
+				return 0;
+			}
+		}
+
+		void OpenGLRendererAPI::CopyTexture(const RenderCommand& cmd)
+		{
+			TextureDataView* source = cmd.CopyTextureCmdDesc.Source;
+			TextureDataView* destination = cmd.CopyTextureCmdDesc.Destination;
+
+			glCopyImageSubData((uint32_t)source->Identifier, GetGLTextureTarget(source->Type), 0, 0, 0, cmd.CopyTextureCmdDesc.SourceLayer,
+				(uint32_t)destination->Identifier, GetGLTextureTarget(destination->Type), 0, 0, 0, cmd.CopyTextureCmdDesc.DestinationLayer,
+				source->Size.x, source->Size.y, cmd.CopyTextureCmdDesc.LayerCount);
+		}
+
+		void OpenGLRendererAPI::ClearTexture(const RenderCommand& cmd)
+		{
+			//a null pointer clears to zero in every channel
+			glClearTexImage((uint32_t)cmd.ClearTextureCmdDesc.Texture->Identifier, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 		}
 
 		void OpenGLRendererAPI::UpdateTextureNew(const RenderCommand& cmd)
@@ -755,13 +995,17 @@ namespace Ainan {
 			default:
 				AINAN_LOG_FATAL("Unkown texture type specified");
 			}
-			delete[] data;
 		}
 
 		void OpenGLRendererAPI::DestroyTexture(const RenderCommand& cmd)
 		{
 			uint32_t tex = cmd.DestroyTextureCmdDesc.Texture->Identifier;
 			glDeleteTextures(1, &tex);
+			if (cmd.DestroyTextureCmdDesc.Texture->LayerView != std::numeric_limits<uint64_t>::max())
+			{
+				uint32_t layerView = cmd.DestroyTextureCmdDesc.Texture->LayerView;
+				glDeleteTextures(1, &layerView);
+			}
 			cmd.DestroyTextureCmdDesc.Texture->Deleted = true;
 		}
 
@@ -778,8 +1022,80 @@ namespace Ainan {
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		}
 
+		void OpenGLRendererAPI::InsertFence(const RenderCommand& cmd)
+		{
+			cmd.InsertFenceCmdDesc.Fence->Identifier = (uint64_t)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_PendingFences.push_back(cmd.InsertFenceCmdDesc.Fence);
+		}
+
+		void OpenGLRendererAPI::WaitFence(const RenderCommand& cmd)
+		{
+			FenceDataView* fence = cmd.WaitFenceCmdDesc.Fence;
+
+			//PollFences can find that the gpu passed the fence after the wait was pushed
+			if (fence->Signaled.load(std::memory_order_relaxed))
+				return;
+
+			GLsync sync = (GLsync)fence->Identifier;
+
+			//flush on the first wait so the fence is guaranteed to be reached, then keep waiting in 1ms steps
+			GLenum result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			while (result == GL_TIMEOUT_EXPIRED)
+				result = glClientWaitSync(sync, 0, 1000000);
+
+			glDeleteSync(sync);
+			fence->Identifier = 0;
+			fence->Signaled.store(true, std::memory_order_release);
+
+			//readback fences are waited on without being inserted with InsertFence
+			auto it = std::find(m_PendingFences.begin(), m_PendingFences.end(), fence);
+			if (it != m_PendingFences.end())
+				m_PendingFences.erase(it);
+		}
+
+		void OpenGLRendererAPI::PollFences()
+		{
+			auto it = m_PendingFences.begin();
+			while (it != m_PendingFences.end())
+			{
+				FenceDataView* fence = *it;
+				GLsync sync = (GLsync)fence->Identifier;
+
+				//a timeout of 0 only checks the fence
+				GLenum result = glClientWaitSync(sync, 0, 0);
+				if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+				{
+					it++;
+					continue;
+				}
+
+				glDeleteSync(sync);
+				fence->Identifier = 0;
+				fence->Signaled.store(true, std::memory_order_release);
+				it = m_PendingFences.erase(it);
+			}
+		}
+
+		void OpenGLRendererAPI::DrawInstanced(const RenderCommand& cmd)
+		{
+			glUseProgram(cmd.DrawInstancedCmdDesc.Shader->Identifier);
+			glBindVertexArray(cmd.DrawInstancedCmdDesc.VertexBuffer->Array);
+			glBindBuffer(GL_ARRAY_BUFFER, cmd.DrawInstancedCmdDesc.VertexBuffer->Identifier);
+
+			glDrawArraysInstancedBaseInstance(GetOpenGLPrimitive(cmd.DrawInstancedCmdDesc.DrawingPrimitive), 0,
+				cmd.DrawInstancedCmdDesc.VertexCount, cmd.DrawInstancedCmdDesc.InstanceCount, cmd.DrawInstancedCmdDesc.FirstInstance);
+
+			glUseProgram(0);
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+
 		void OpenGLRendererAPI::ImGuiNewFrame()
 		{
+			//the font texture is only made once, it's only written by the renderer thread inside the wait below
+			if (FontTexture)
+				return;
+
 			auto func = [this]()
 			{
 				if (!FontTexture)
@@ -867,10 +1183,11 @@ namespace Ainan {
 					{
 						RenderCommand cmd;
 						cmd.Type = RenderCommandType::CreateIndexBuffer;
-						auto vBufferInfo = new IndexBufferCreationInfo;
-						vBufferInfo->InitialData = nullptr;
-						vBufferInfo->Count = 0;
-						cmd.CreateIndexBufferCmdDesc.Info = vBufferInfo;
+						//index buffer infos aren't deleted by CreateIndexBuffer
+						IndexBufferCreationInfo iBufferInfo;
+						iBufferInfo.InitialData = nullptr;
+						iBufferInfo.Count = 0;
+						cmd.CreateIndexBufferCmdDesc.Info = &iBufferInfo;
 						cmd.CreateIndexBufferCmdDesc.Output = &ImGuiIndexBuffer;
 						CreateIndexBuffer(cmd);
 					}
@@ -910,35 +1227,45 @@ namespace Ainan {
 
 		void OpenGLRendererAPI::ImGuiEndFrame(bool redraw)
 		{
-			auto func = []()
+			//ImGui windows outside the main window (platform windows) are made and drawn by ImGui on this thread, so the renderer
+			//thread has to give up the context for that. with only the main viewport there is nothing to do here and the
+			//renderer thread keeps executing the last frame while this one is recorded
+			bool hasPlatformWindows = ImGui::GetPlatformIO().Viewports.Size > 1;
+			if (hasPlatformWindows)
 			{
+				auto func = []()
+				{
+					glfwMakeContextCurrent(nullptr);
+				};
+				Renderer::PushCommand(func);
+				Renderer::WaitUntilRendererIdle();
+
+				glfwMakeContextCurrent(Window::Ptr);
+				ImGui::UpdatePlatformWindows();
+				if (redraw)
+					ImGui::RenderPlatformWindowsDefault();
 				glfwMakeContextCurrent(nullptr);
-			};
-			Renderer::PushCommand(func);
-			Renderer::WaitUntilRendererIdle();
 
-			glfwMakeContextCurrent(Window::Ptr);
-			ImGui::UpdatePlatformWindows();
-			glfwMakeContextCurrent(nullptr);
-			if (!redraw)
-			{
-				auto func2 = [this]()
+				auto func2 = []()
 				{
 					glfwMakeContextCurrent(Window::Ptr);
 				};
 				Renderer::PushCommand(func2);
-				Renderer::WaitUntilRendererIdle();
-				return;
 			}
+			else
+				ImGui::UpdatePlatformWindows();
+
+			if (!redraw)
+				return;
 
-			ImGui::RenderPlatformWindowsDefault();
-			auto func2 = [this]()
+			//ImGui reuses its draw lists next frame, so the renderer thread draws a copy of them
+			ImDrawData* drawData = Renderer::CopyImGuiDrawData(ImGui::GetDrawData());
+			auto func3 = [this, drawData]()
 			{
-				glfwMakeContextCurrent(Window::Ptr);
-				DrawImGui(ImGui::GetDrawData());
+				DrawImGui(drawData);
+				Renderer::DeleteImGuiDrawData(drawData);
 			};
-			Renderer::PushCommand(func2);
-			Renderer::WaitUntilRendererIdle();
+			Renderer::PushCommand(func3);
 		}
 
 		void OpenGLRendererAPI::InitImGui()
@@ -1137,7 +1464,11 @@ namespace Ainan {
 
 		void OpenGLRendererAPI::Present()
 		{
-			glfwSwapBuffers(Window::Ptr);
+			//there is nothing to show in headless mode, just make sure the frame is sent to the gpu
+			if (Window::Headless)
+				glFlush();
+			else
+				glfwSwapBuffers(Window::Ptr);
 			Window::WindowSizeChangedSinceLastFrame = false;
 		}
 	}
@@ -48,6 +48,7 @@ namespace Ainan {
 			virtual RendererContext* GetContext() override { return &Context; };
 
 			virtual void SetBlendMode(RenderingBlendMode blendMode) override;
+			virtual void PollFences() override;
 
 			OpenGLRendererContext Context;
 
@@ -81,12 +82,24 @@ namespace Ainan {
 			void UpdateVertexBufferNew(const RenderCommand& cmd);
 			void DrawIndexedWithCustomNumberOfVertices(const RenderCommand& cmd);
 			void ReadFramebuffer(const RenderCommand& cmd);
+			void ReadFramebufferAsync(const RenderCommand& cmd);
+			void MapReadbackBuffer(const RenderCommand& cmd);
+			void DestroyReadbackBuffer(const RenderCommand& cmd);
 			void DestroyFramebufferNew(const RenderCommand& cmd);
 			void CreateTexture(const RenderCommand& cmd);
 			void UpdateTextureNew(const RenderCommand& cmd);
+			void UpdateTextureRegion(const RenderCommand& cmd);
+			void CopyTexture(const RenderCommand& cmd);
+			void ClearTexture(const RenderCommand& cmd);
 			void DestroyTexture(const RenderCommand& cmd);
 			void DrawNew(const RenderCommand& cmd);
+			void DrawInstanced(const RenderCommand& cmd);
+			void InsertFence(const RenderCommand& cmd);
+			void WaitFence(const RenderCommand& cmd);
 			void SetViewport(const Rectangle& viewport);
+
+			//fences inserted with InsertFence that the gpu hadn't passed the last time they were checked
+			std::vector<FenceDataView*> m_PendingFences;
 		};
 	}
 }
@@ -1,6 +1,6 @@
 #include <Windows.h>
 
-extern int main();
+extern int main(int argc, char** argv);
 
 int WinMain(
 	HINSTANCE hInstance,
@@ -17,5 +17,5 @@ int WinMain(
 
 #endif // DEBUG
 
-	return main();
+	return main(__argc, __argv);
 }
\ No newline at end of file